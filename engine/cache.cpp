@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cache.h"
+#include "evaluate.h"
+#include "nnue.h"
+#include "position.h"
+
+static_assert(sizeof(AnalysisCache::Entry) == 16, "the file layout depends on the entry size");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "entries are shared with other processes");
+
+const char cacheMagic[8] = {'C', 'H', 'E', 'S', 'S', 'C', 'A', 'C'};
+
+AnalysisCache *analysisCache = nullptr;
+
+AnalysisCache::~AnalysisCache()
+{
+	if (mapping) munmap(mapping, mappingSize);
+}
+
+int lockCurrentFile(const std::string &path) //locked, and still the file at path, not one a reset in another process renamed over
+{
+	while (true)
+	{
+		int file = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+		if (file < 0) return -1;
+		flock(file, LOCK_EX);
+		struct stat opened;
+		struct stat current;
+		if (fstat(file, &opened) == 0 && stat(path.c_str(), &current) == 0
+		&& opened.st_dev == current.st_dev && opened.st_ino == current.st_ino) return file;
+		flock(file, LOCK_UN);
+		close(file);
+	}
+}
+
+bool AnalysisCache::open(const std::string &path, std::size_t megabytes)
+{
+	int file = lockCurrentFile(path); //one process at a time checks or rebuilds the layout, entries are lockless afterwards
+	if (file < 0)
+	{
+		status = "could not open " + path;
+		return false;
+	}
+	std::size_t size = 1;
+	while (size * 2 * sizeof(Entry) <= megabytes << 20) size *= 2;
+	struct stat info;
+	fstat(file, &info);
+	Header header = {};
+	bool valid = static_cast<std::size_t>(info.st_size) >= sizeof(Header)
+	&& pread(file, &header, sizeof(Header), 0) == static_cast<ssize_t>(sizeof(Header));
+	if (!valid) status = info.st_size == 0 ? "created " + path : "reset " + path + ": truncated header";
+	else if (std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0)
+	{
+		status = "reset " + path + ": not a cache file";
+		valid = false;
+	}
+	else if (header.version != version || header.entrySize != sizeof(Entry))
+	{
+		status = "reset " + path + ": version " + std::to_string(header.version) + ", expected " + std::to_string(version);
+		valid = false;
+	}
+	else if (header.entryCount == 0 || (header.entryCount & (header.entryCount-1)) != 0
+	|| static_cast<std::size_t>(info.st_size) != sizeof(Header) + header.entryCount * sizeof(Entry))
+	{
+		status = "reset " + path + ": truncated";
+		valid = false;
+	}
+	if (valid)
+	{
+		size = header.entryCount; //the existing size wins over the requested one
+		status = "opened " + path;
+	}
+	else
+	{
+		//a new file renamed over the old one, so processes still mapping the old one keep their pages instead of faulting on a truncated file
+		std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+		header.version = version;
+		header.entrySize = sizeof(Entry);
+		header.entryCount = size;
+		std::string temporary = path + ".new" + std::to_string(getpid());
+		int fresh = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+		if (fresh < 0 || ftruncate(fresh, sizeof(Header) + size * sizeof(Entry)) != 0 //zero filled
+		|| pwrite(fresh, &header, sizeof(Header), 0) != static_cast<ssize_t>(sizeof(Header))
+		|| rename(temporary.c_str(), path.c_str()) != 0)
+		{
+			status = "could not write " + path;
+			if (fresh >= 0)
+			{
+				close(fresh);
+				unlink(temporary.c_str());
+			}
+			flock(file, LOCK_UN);
+			close(file);
+			return false;
+		}
+		flock(file, LOCK_UN); //processes waiting on the old file see it was replaced and open the new one
+		close(file);
+		file = fresh;
+	}
+	mappingSize = sizeof(Header) + size * sizeof(Entry);
+	mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+	flock(file, LOCK_UN);
+	close(file);
+	if (mapping == MAP_FAILED)
+	{
+		mapping = nullptr;
+		status = "could not map " + path;
+		return false;
+	}
+	entries = reinterpret_cast<Entry*>(static_cast<char*>(mapping) + sizeof(Header));
+	count = size;
+	return true;
+}
+
+bool AnalysisCache::probe(uint64_t key, CachedResult &result)
+{
+	if (!entries) return false;
+	Entry &entry = entries[key & (count-1)];
+	uint64_t data = entry.data.load(std::memory_order_relaxed);
+	if ((entry.check.load(std::memory_order_relaxed) ^ data) != key || data == 0) return false;
+	result.depth = static_cast<int>(data & 0xFF);
+	int from = static_cast<int>(data >> 8 & 0x3F);
+	int to = static_cast<int>(data >> 14 & 0x3F);
+	result.move = {{from/8, from%8}, {to/8, to%8}, data >> 20 & 1 ? 'q' : '\0'};
+	uint32_t bits = static_cast<uint32_t>(data >> 32);
+	std::memcpy(&result.value, &bits, sizeof(float));
+	return true;
+}
+
+void AnalysisCache::store(uint64_t key, const CachedResult &result)
+{
+	if (!entries) return;
+	CachedResult existing;
+	if (probe(key, existing) && existing.depth > result.depth) return;
+	Entry &entry = entries[key & (count-1)];
+	uint32_t bits;
+	std::memcpy(&bits, &result.value, sizeof(float));
+	uint64_t from = result.move.from[0]*8 + result.move.from[1];
+	uint64_t to = result.move.to[0]*8 + result.move.to[1];
+	uint64_t data = static_cast<uint64_t>(bits) << 32 | static_cast<uint64_t>(result.move.promotion != 0) << 20
+	| to << 14 | from << 8 | static_cast<uint64_t>(std::min(result.depth, 255));
+	entry.check.store(key ^ data, std::memory_order_relaxed);
+	entry.data.store(data, std::memory_order_relaxed);
+}
+
+uint64_t cacheKey(Position &position)
+{
+	uint64_t key = positionKey(position);
+	if (evalSettings.pawnStructure) key ^= 0x2545F4914F6CDD1Dull;
+	if (nnueActive()) key ^= 0x9E3779B97F4A7C15ull ^ network.hash; //which network, not only whether there is one
+	return key;
+}
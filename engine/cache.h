@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "position.h"
+
+struct CachedResult
+{
+	int depth;
+	float value;
+	Move move;
+};
+
+struct AnalysisCache //root search results kept across runs in a memory-mapped file, lockless like TranspositionTable
+{
+	struct Header
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t entrySize;
+		uint64_t entryCount;
+	};
+	struct Entry
+	{
+		std::atomic<uint64_t> check; //key ^ data, so a torn or foreign entry never matches
+		std::atomic<uint64_t> data; //value bits << 32 | promotion << 20 | to << 14 | from << 8 | depth
+	};
+	static const uint32_t version = 2; //bumped when search results change meaning
+
+	Entry *entries = nullptr;
+	std::size_t count = 0;
+	void *mapping = nullptr;
+	std::size_t mappingSize = 0;
+	std::string status; //what open found, for the caller to report
+
+	AnalysisCache() {}
+	AnalysisCache(const AnalysisCache&) = delete;
+	AnalysisCache &operator=(const AnalysisCache&) = delete;
+	~AnalysisCache();
+	bool open(const std::string &path, std::size_t megabytes); //creates or resets the file when it is missing, truncated or another version
+	bool probe(uint64_t key, CachedResult &result);
+	void store(uint64_t key, const CachedResult &result); //keeps the deeper result for the same position
+};
+
+extern AnalysisCache *analysisCache; //consulted by generateBotMove when a caller installs it
+uint64_t cacheKey(Position &position); //the position key, salted with the evaluation settings and network the value depends on
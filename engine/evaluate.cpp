@@ -0,0 +1,260 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "evaluate.h"
+#include "position.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+struct PawnEntry
+{
+	uint64_t key;
+	float score;
+	std::array<uint64_t, 2> passed; //0 is light, 1 is dark, bit x*8+y
+};
+
+struct PawnHashTable
+{
+	std::vector<PawnEntry> entries = std::vector<PawnEntry>(1 << 14, PawnEntry{0, 0.f, {0, 0}});
+	PawnEntry &operator[](uint64_t key)
+	{
+		return entries[key & (entries.size()-1)];
+	}
+};
+
+thread_local PawnHashTable pawnHashTable;
+
+PawnEntry evaluatePawns(Position &position, uint64_t key)
+{
+	std::array<float, 6> passedBonus = {0.1f, 0.15f, 0.25f, 0.4f, 0.6f, 0.9f};
+	PawnEntry entry = {key, 0.f, {0, 0}};
+	std::array<std::array<int, 8>, 2> files = {}; //pawn count per file
+	std::array<std::array<int, 8>, 2> rearmost = {}; //row of the rearmost pawn per file, -1 if none
+	for (int side{0}; side<2; side++) rearmost[side].fill(-1);
+	for (int x{0}; x<8; x++)
+	{
+		for (int y{0}; y<8; y++)
+		{
+			if (position[x][y] == "pl")
+			{
+				files[0][y]++;
+				rearmost[0][y] = std::max(rearmost[0][y], x);
+			}
+			if (position[x][y] == "pd")
+			{
+				files[1][y]++;
+				if (rearmost[1][y] == -1) rearmost[1][y] = x;
+			}
+		}
+	}
+	for (int x{1}; x<7; x++)
+	{
+		for (int y{0}; y<8; y++)
+		{
+			if (position[x][y] != "pl" && position[x][y] != "pd") continue;
+			int side = position[x][y][1] == 'l' ? 0 : 1;
+			int forward = side == 0 ? -1 : 1;
+			std::string enemy = side == 0 ? "pd" : "pl";
+			float value = 0.f;
+
+			bool isolated = (y == 0 || files[side][y-1] == 0) && (y == 7 || files[side][y+1] == 0);
+			if (isolated) value -= 0.15f;
+
+			bool passed = true;
+			for (int i{x+forward}; i>=0 && i<8 && passed; i+=forward)
+				for (int j{std::max(y-1, 0)}; j<=std::min(y+1, 7); j++)
+					if (position[i][j] == enemy) passed = false;
+			if (passed)
+			{
+				int advance = side == 0 ? 6-x : x-1;
+				value += passedBonus[advance];
+				entry.passed[side] |= 1ull << (x*8+y);
+			}
+
+			bool supportable = false; //a friendly pawn level with or behind this one on an adjacent file
+			for (int j{y-1}; j<=y+1; j+=2)
+			{
+				if (j < 0 || j > 7 || files[side][j] == 0) continue;
+				if (side == 0 && rearmost[0][j] >= x) supportable = true;
+				if (side == 1 && rearmost[1][j] != -1 && rearmost[1][j] <= x) supportable = true;
+			}
+			int attackRow = x+2*forward;
+			bool stopAttacked = attackRow >= 0 && attackRow < 8
+			&& ((y > 0 && position[attackRow][y-1] == enemy) || (y < 7 && position[attackRow][y+1] == enemy));
+			if (!isolated && !supportable && stopAttacked) value -= 0.1f;
+
+			entry.score += side == 0 ? value : -value;
+		}
+	}
+	for (int y{0}; y<8; y++)
+	{
+		if (files[0][y] > 1) entry.score -= 0.2f * static_cast<float>(files[0][y]-1);
+		if (files[1][y] > 1) entry.score += 0.2f * static_cast<float>(files[1][y]-1);
+	}
+	return entry;
+}
+
+std::array<std::array<int16_t, 64>, 13> materialTable = []() //in twentieths of a pawn, index 12 is an empty square
+{
+	std::array<int, 6> values = {1, 3, 3, 5, 9, 0};
+	std::array<std::array<int16_t, 64>, 13> table = {};
+	for (int piece{0}; piece<12; piece++)
+	{
+		for (int x{0}; x<8; x++)
+		{
+			for (int y{0}; y<8; y++)
+			{
+				int xQuality = x < 4 ? x : 7-x;
+				int yQuality = y < 4 ? y : 7-y;
+				if (piece == 0) yQuality = 7-y;
+				if (piece == 6) yQuality = y;
+				int multiplier = 20+xQuality+yQuality;
+				if (piece%6 == 3) multiplier = 20;
+				if (piece >= 6) multiplier = -multiplier;
+				table[piece][x*8+y] = static_cast<int16_t>(values[piece%6] * multiplier);
+			}
+		}
+	}
+	return table;
+}();
+
+int materialScalar(const std::array<int8_t, 64> &codes)
+{
+	int sum = 0;
+	for (int square{0}; square<64; square++) sum += materialTable[codes[square]][square];
+	return sum;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+struct MaterialLanes //materialTable split into per-square weights times per-piece values
+{
+	alignas(32) std::array<std::array<uint8_t, 64>, 4> weights; //pieces, rooks, light pawns, dark pawns
+	alignas(16) std::array<std::array<int8_t, 16>, 4> values; //indexed by piece code
+};
+
+MaterialLanes materialLanes = []()
+{
+	MaterialLanes lanes = {};
+	for (int x{0}; x<8; x++)
+	{
+		for (int y{0}; y<8; y++)
+		{
+			int xQuality = x < 4 ? x : 7-x;
+			int yQuality = y < 4 ? y : 7-y;
+			lanes.weights[0][x*8+y] = static_cast<uint8_t>(20+xQuality+yQuality);
+			lanes.weights[1][x*8+y] = 20;
+			lanes.weights[2][x*8+y] = static_cast<uint8_t>(20+xQuality+7-y);
+			lanes.weights[3][x*8+y] = static_cast<uint8_t>(20+xQuality+y);
+		}
+	}
+	lanes.values[0][1] = 3; lanes.values[0][2] = 3; lanes.values[0][4] = 9;
+	lanes.values[0][7] = -3; lanes.values[0][8] = -3; lanes.values[0][10] = -9;
+	lanes.values[1][3] = 5; lanes.values[1][9] = -5;
+	lanes.values[2][0] = 1;
+	lanes.values[3][6] = -1;
+	return lanes;
+}();
+
+__attribute__((target("sse4.1")))
+int materialSse4(const std::array<int8_t, 64> &codes)
+{
+	__m128i sum = _mm_setzero_si128();
+	for (int block{0}; block<4; block++)
+	{
+		__m128i pieces = _mm_loadu_si128(reinterpret_cast<const __m128i*>(codes.data()+block*16));
+		__m128i values = _mm_setzero_si128();
+		for (int lane{0}; lane<4; lane++)
+		{
+			__m128i weights = _mm_load_si128(reinterpret_cast<const __m128i*>(materialLanes.weights[lane].data()+block*16));
+			__m128i pieceValues = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(materialLanes.values[lane].data())), pieces);
+			values = _mm_add_epi16(values, _mm_maddubs_epi16(weights, pieceValues));
+		}
+		sum = _mm_add_epi32(sum, _mm_madd_epi16(values, _mm_set1_epi16(1)));
+	}
+	sum = _mm_hadd_epi32(sum, sum);
+	sum = _mm_hadd_epi32(sum, sum);
+	return _mm_cvtsi128_si32(sum);
+}
+
+__attribute__((target("avx2")))
+int materialAvx2(const std::array<int8_t, 64> &codes)
+{
+	__m256i sum = _mm256_setzero_si256();
+	for (int block{0}; block<2; block++)
+	{
+		__m256i pieces = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(codes.data()+block*32));
+		__m256i values = _mm256_setzero_si256();
+		for (int lane{0}; lane<4; lane++)
+		{
+			__m256i weights = _mm256_load_si256(reinterpret_cast<const __m256i*>(materialLanes.weights[lane].data()+block*32));
+			__m256i table = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(materialLanes.values[lane].data())));
+			values = _mm256_add_epi16(values, _mm256_maddubs_epi16(weights, _mm256_shuffle_epi8(table, pieces)));
+		}
+		sum = _mm256_add_epi32(sum, _mm256_madd_epi16(values, _mm256_set1_epi16(1)));
+	}
+	__m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+	half = _mm_hadd_epi32(half, half);
+	half = _mm_hadd_epi32(half, half);
+	return _mm_cvtsi128_si32(half);
+}
+#endif
+
+std::vector<MaterialKernel> availableMaterialKernels()
+{
+	std::vector<MaterialKernel> kernels = {{"scalar", materialScalar}};
+#if defined(__x86_64__) || defined(__i386__)
+	if (__builtin_cpu_supports("sse4.1")) kernels.push_back({"sse4", materialSse4});
+	if (__builtin_cpu_supports("avx2")) kernels.push_back({"avx2", materialAvx2});
+#endif
+	return kernels;
+}
+
+int (*materialKernel)(const std::array<int8_t, 64>&) = availableMaterialKernels().back().function;
+
+thread_local EvalSettings evalSettings;
+
+float evaluateClassic(Position &position)
+{
+	std::array<int8_t, 64> codes;
+	uint64_t pawnKey = 0;
+	for (int x{0}; x<8; x++)
+	{
+		for (int y{0}; y<8; y++)
+		{
+			if (position[x][y] == "")
+			{
+				codes[x*8+y] = 12;
+				continue;
+			}
+			int piece = pieceIndex(position[x][y]);
+			codes[x*8+y] = static_cast<int8_t>(piece);
+			if (piece%6 == 0) pawnKey ^= zobristPieces[piece][x*8+y];
+		}
+	}
+	float value = static_cast<float>(materialKernel(codes)) / 20.f;
+	if (!evalSettings.pawnStructure) return value;
+	PawnEntry &entry = pawnHashTable[pawnKey];
+	if (entry.key != pawnKey) entry = evaluatePawns(position, pawnKey);
+	value += entry.score;
+	for (int side{0}; side<2; side++) //passed pawns with a free path to promotion
+	{
+		for (uint64_t passed = entry.passed[side]; passed; passed &= passed-1)
+		{
+			int square = __builtin_ctzll(passed);
+			int x = square/8;
+			int y = square%8;
+			bool free = true;
+			for (int i{side == 0 ? x-1 : x+1}; i>=0 && i<8 && free; i+=(side == 0 ? -1 : 1))
+				if (position[i][y] != "") free = false;
+			if (free) value += side == 0 ? 0.1f : -0.1f;
+		}
+	}
+	return value;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "position.h"
+
+struct MaterialKernel
+{
+	std::string name;
+	int (*function)(const std::array<int8_t, 64>&);
+};
+
+std::vector<MaterialKernel> availableMaterialKernels();
+extern int (*materialKernel)(const std::array<int8_t, 64>&);
+
+struct EvalSettings
+{
+	bool pawnStructure = true;
+	bool nnue = true; //only when a network is loaded
+	float noise = 0.f; //pawns of random error added to every leaf
+};
+
+extern thread_local EvalSettings evalSettings;
+float evaluateClassic(Position &position);
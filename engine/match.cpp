@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "match.h"
+#include "notation.h"
+#include "pgn.h"
+#include "position.h"
+#include "search.h"
+
+bool parseEngineConfig(const std::string &text, EngineConfig &config)
+{
+	std::istringstream stream(text);
+	std::string option;
+	while (std::getline(stream, option, ','))
+	{
+		auto split = option.find('=');
+		if (split == std::string::npos) return false;
+		std::string key = option.substr(0, split);
+		std::string value = option.substr(split+1);
+		if (key == "name") config.name = value;
+		else if (key == "depth") config.depth = std::stoi(value);
+		else if (key == "time") config.moveTime = std::stoi(value);
+		else if (key == "pawns") config.evalSettings.pawnStructure = value == "1";
+		else if (key == "nnue") config.evalSettings.nnue = value == "1";
+		else if (key == "mcts") config.mcts.enabled = value == "1";
+		else if (key == "playouts") config.mcts.playouts = std::stoll(value);
+		else if (key == "threads") config.mcts.threads = std::max(std::stoi(value), 1);
+		else return false;
+	}
+	return config.depth > 0;
+}
+
+Position searchMove(Position &position, EngineConfig &config)
+{
+	evalSettings = config.evalSettings;
+	mctsSettings = config.mcts;
+	mctsSettings.moveTime = config.moveTime;
+	return generateBotMove(position, config.depth, config.moveTime);
+}
+
+GameRecord playGame(const std::string &fen, EngineConfig &light, EngineConfig &dark, int maxPlies)
+{
+	GameRecord record = {fen, {}, "1/2-1/2", "max plies"};
+	Position position;
+	positionFromFen(fen, position);
+	std::map<uint64_t, int> repetitions = {};
+	repetitions[positionKey(position)]++;
+	int halfmoves = 0;
+	for (int ply{0}; ply<maxPlies; ply++)
+	{
+		if (legalMoves(position).empty())
+		{
+			position.toggleTurn();
+			bool mate = isCheck(position);
+			position.toggleTurn();
+			if (mate) record.result = position.turnPlayer == 'l' ? "0-1" : "1-0";
+			record.termination = mate ? "checkmate" : "stalemate";
+			return record;
+		}
+		Position next = searchMove(position, position.turnPlayer == 'l' ? light : dark);
+		Move move = moveBetween(position, next);
+		bool capture = position[move.to[0]][move.to[1]] != "";
+		bool pawn = position[move.from[0]][move.from[1]][0] == 'p';
+		record.moves.push_back(moveToSan(position, next));
+		position = next;
+		halfmoves = capture || pawn ? 0 : halfmoves+1;
+		if (halfmoves >= 100)
+		{
+			record.termination = "fifty moves";
+			return record;
+		}
+		if (++repetitions[positionKey(position)] >= 3)
+		{
+			record.termination = "repetition";
+			return record;
+		}
+		if (insufficientMaterial(position))
+		{
+			record.termination = "insufficient material";
+			return record;
+		}
+	}
+	return record;
+}
+
+double eloFromScore(double score)
+{
+	score = std::min(std::max(score, 1e-6), 1-1e-6);
+	return -400.0 * std::log10(1.0/score - 1.0);
+}
+
+double scoreFromElo(double elo)
+{
+	return 1.0 / (1.0 + std::pow(10.0, -elo/400.0));
+}
+
+double sprtLlr(MatchScore &score, double elo0, double elo1)
+{
+	double variance = score.variance();
+	if (score.games() == 0 || variance <= 0) return 0.0;
+	double s0 = scoreFromElo(elo0);
+	double s1 = scoreFromElo(elo1);
+	return 0.5 * score.games() * (s1 - s0) * (2*score.score() - s0 - s1) / variance;
+}
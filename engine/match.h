@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+
+#include "evaluate.h"
+#include "mcts.h"
+#include "pgn.h"
+
+struct EngineConfig
+{
+	std::string name;
+	int depth = 3;
+	int moveTime = 0; //milliseconds, 0 searches to depth
+	EvalSettings evalSettings;
+	MctsSettings mcts;
+};
+
+bool parseEngineConfig(const std::string &text, EngineConfig &config);
+Position searchMove(Position &position, EngineConfig &config);
+GameRecord playGame(const std::string &fen, EngineConfig &light, EngineConfig &dark, int maxPlies);
+
+struct MatchScore
+{
+	int wins = 0; //for the first engine
+	int losses = 0;
+	int draws = 0;
+	int games() const
+	{
+		return wins + losses + draws;
+	}
+	double score() const
+	{
+		return (wins + 0.5*draws) / games();
+	}
+	double variance() const //per game
+	{
+		double s = score();
+		return (wins*(1-s)*(1-s) + draws*(0.5-s)*(0.5-s) + losses*s*s) / games();
+	}
+};
+
+double eloFromScore(double score);
+double scoreFromElo(double elo);
+double sprtLlr(MatchScore &score, double elo0, double elo1); //trinomial GSPRT approximation
@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "mcts.h"
+#include "evaluate.h"
+#include "nnue.h"
+#include "position.h"
+#include "search.h"
+
+thread_local MctsSettings mctsSettings;
+thread_local MctsPool mctsPool; //of the thread that starts a search, shared with the threads it starts
+
+struct MctsSearch //what the threads of one search share
+{
+	MctsPool &pool;
+	MctsSettings settings;
+	EvalSettings evalSettings;
+	Position root;
+	long long playouts;
+	bool timed;
+	std::chrono::steady_clock::time_point deadline;
+	std::atomic<long long> started{0};
+	std::atomic<long long> completed{0};
+};
+
+float leafValue(Position &position, int depth) //chance the side to move wins, from the alpha-beta value in pawns
+{
+	if (insufficientMaterial(position)) return 0.5f;
+	nnueRoot(position);
+	float value = evaluate(position, depth, -5000.f, 5000.f, 0.f);
+	nnueDone();
+	if (position.turnPlayer == 'd') value = -value;
+	return 1.f / (1.f + std::pow(10.f, -value / 4.f));
+}
+
+float expand(MctsSearch &search, int32_t index, Position &position) //the leaf value, after giving the node its children
+{
+	MctsNode &node = search.pool[index];
+	MoveGenerator moveGenerator = {position, false};
+	moveGenerator.orderCaptures();
+	std::array<GenMove, maxMoves> moves;
+	std::array<float, maxMoves> scores; //priors before normalising, there is no policy to learn them from
+	int count = 0;
+	for (moveGenerator.next(); !moveGenerator.done; moveGenerator.next())
+	{
+		moves[count] = moveGenerator.moves[moveGenerator.index-1];
+		float score = moveGenerator.lastCapture ? std::min(std::max(moveGenerator.lastExchange / 300.f, -2.f), 2.f) : 0.f;
+		if (moves[count].flags & GenMove::promotion) score += 1.f;
+		scores[count++] = std::exp(score);
+	}
+	if (count == 0)
+	{
+		position.toggleTurn();
+		node.terminal = isCheck(position) ? 0 : 1;
+		position.toggleTurn();
+		node.state.store(2, std::memory_order_release);
+		return node.terminal * 0.5f;
+	}
+	int32_t first = search.pool.allocate(count);
+	if (first < 0)
+	{
+		node.state.store(0, std::memory_order_release);
+		return leafValue(position, search.settings.leafDepth);
+	}
+	float total = 0.f;
+	for (int n{0}; n<count; n++) total += scores[n];
+	for (int n{0}; n<count; n++)
+	{
+		search.pool[first+n].move = moves[n];
+		search.pool[first+n].prior = scores[n] / total;
+	}
+	node.firstChild = first;
+	node.childCount = count;
+	node.state.store(2, std::memory_order_release); //publishes the children to threads that see the node expanded
+	return leafValue(position, search.settings.leafDepth);
+}
+
+float average(MctsNode &node, int visits)
+{
+	return static_cast<float>(node.valueSum.load(std::memory_order_relaxed)) / MctsNode::valueScale / visits;
+}
+
+int32_t select(MctsSearch &search, MctsNode &node) //PUCT, with virtual losses steering threads apart
+{
+	float parentVisits = static_cast<float>(node.visits.load(std::memory_order_relaxed) + node.virtualLoss.load(std::memory_order_relaxed));
+	float explore = search.settings.exploration * std::sqrt(std::max(parentVisits, 1.f));
+	int32_t best = node.firstChild;
+	float bestScore = -1e9f;
+	for (int32_t child{node.firstChild}; child<node.firstChild+node.childCount; child++)
+	{
+		MctsNode &candidate = search.pool[child];
+		int visits = candidate.visits.load(std::memory_order_relaxed) + candidate.virtualLoss.load(std::memory_order_relaxed);
+		float score = (visits == 0 ? 0.5f : average(candidate, visits)) + explore * candidate.prior / (1 + visits);
+		if (score <= bestScore) continue;
+		bestScore = score;
+		best = child;
+	}
+	return best;
+}
+
+void playout(MctsSearch &search)
+{
+	Position position = search.root;
+	std::array<int32_t, 128> path;
+	int length = 0;
+	int32_t index = 0;
+	float result; //for the side to move at the end of the path
+	while (true)
+	{
+		MctsNode &node = search.pool[index];
+		path[length++] = index;
+		int32_t state = node.state.load(std::memory_order_acquire);
+		if (state != 2)
+		{
+			int32_t expected = 0;
+			if (state == 0 && node.state.compare_exchange_strong(expected, 1)) result = expand(search, index, position);
+			else result = leafValue(position, search.settings.leafDepth); //another thread is expanding it
+			break;
+		}
+		if (node.terminal >= 0)
+		{
+			result = node.terminal * 0.5f;
+			break;
+		}
+		if (length == static_cast<int>(path.size()))
+		{
+			result = leafValue(position, search.settings.leafDepth);
+			break;
+		}
+		index = select(search, node);
+		search.pool[index].virtualLoss++;
+		playMove(position, search.pool[index].move);
+	}
+	for (int n{length-1}; n>=0; n--)
+	{
+		result = 1.f - result; //for the player who moved into the node
+		MctsNode &node = search.pool[path[n]];
+		node.valueSum += std::llround(result * MctsNode::valueScale);
+		node.visits++;
+		if (n > 0) node.virtualLoss--;
+	}
+}
+
+void mctsWorker(MctsSearch &search)
+{
+	evalSettings = search.evalSettings;
+	searchLimits = {};
+	beginSearch();
+	while (search.started++ < search.playouts)
+	{
+		if (search.timed && std::chrono::steady_clock::now() >= search.deadline) break;
+		playout(search);
+		search.completed++;
+	}
+}
+
+Position mctsSearch(Position &position, long long playouts, int milliseconds, MctsReport &report)
+{
+	auto start = std::chrono::steady_clock::now();
+	mctsPool.reserve(mctsSettings.poolNodes);
+	mctsPool.allocate(1); //the root
+	MctsSearch search = {mctsPool, mctsSettings, evalSettings, position, std::max(playouts, 1ll), milliseconds > 0,
+		start + std::chrono::milliseconds(milliseconds)};
+	searchLimits = {};
+	beginSearch();
+	search.started++;
+	playout(search); //expands the root whatever the budget, so there is a move to play
+	search.completed++;
+	std::vector<std::thread> threads = {};
+	for (int n{1}; n<mctsSettings.threads; n++) threads.emplace_back(mctsWorker, std::ref(search));
+	mctsWorker(search);
+	for (std::thread &thread: threads) thread.join();
+	searchLimits = {};
+
+	MctsNode &root = mctsPool[0];
+	report = {search.completed, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(),
+		std::min(mctsPool.used.load(), mctsPool.capacity), 0, 0.5f};
+	if (root.state.load() != 2 || root.childCount == 0) return position; //no legal moves
+	int32_t best = root.firstChild;
+	for (int32_t child{root.firstChild}; child<root.firstChild+root.childCount; child++)
+	{
+		MctsNode &candidate = mctsPool[child];
+		MctsNode &leader = mctsPool[best];
+		if (candidate.visits > leader.visits || (candidate.visits == leader.visits && candidate.prior > leader.prior)) best = child;
+	}
+	MctsNode &chosen = mctsPool[best];
+	report.visits = chosen.visits;
+	if (chosen.visits > 0) report.value = average(chosen, chosen.visits);
+	Position move = position;
+	playMove(move, chosen.move);
+	return move;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "position.h"
+
+struct MctsSettings
+{
+	bool enabled = false; //generateBotMove searches with MCTS instead of alpha-beta
+	int threads = 1;
+	long long playouts = 10000; //per move, the time budget may stop it sooner
+	int moveTime = 0; //milliseconds, 0 for playouts only, used by the depth overload of generateBotMove
+	int leafDepth = 0; //alpha-beta plies before the quiescence search that values a new leaf
+	float exploration = 1.5f; //PUCT constant
+	std::size_t poolNodes = 1 << 18;
+};
+
+extern thread_local MctsSettings mctsSettings;
+
+struct MctsNode
+{
+	GenMove move; //from the parent
+	float prior;
+	int32_t firstChild; //children are contiguous in the pool
+	int32_t childCount;
+	int8_t terminal; //-1 while the game goes on, otherwise the side to move scores 0 when mated, 1 (half) when drawn
+	std::atomic<int32_t> state; //unexpanded, expanding or expanded
+	std::atomic<int32_t> visits;
+	std::atomic<int32_t> virtualLoss; //threads currently below this node, each counting as a lost visit
+	std::atomic<int64_t> valueSum; //results for the player who moved into the node, in 1/valueScale
+	static const int64_t valueScale = 1 << 20;
+};
+
+struct MctsPool //nodes for one search, handed out lock-free in runs of siblings
+{
+	std::unique_ptr<MctsNode[]> nodes;
+	std::size_t capacity = 0;
+	std::atomic<std::size_t> used{0};
+	void reserve(std::size_t count) //only between searches
+	{
+		if (count > capacity)
+		{
+			nodes.reset(new MctsNode[count]);
+			capacity = count;
+		}
+		used = 0;
+	}
+	int32_t allocate(int count) //-1 once the pool is full, and the tree stops growing
+	{
+		std::size_t first = used.fetch_add(count);
+		if (first + count > capacity) return -1;
+		for (std::size_t n{first}; n<first+count; n++)
+		{
+			MctsNode &node = nodes[n];
+			node.prior = 0.f;
+			node.firstChild = -1;
+			node.childCount = 0;
+			node.terminal = -1;
+			node.state.store(0, std::memory_order_relaxed);
+			node.visits.store(0, std::memory_order_relaxed);
+			node.virtualLoss.store(0, std::memory_order_relaxed);
+			node.valueSum.store(0, std::memory_order_relaxed);
+		}
+		return static_cast<int32_t>(first);
+	}
+	MctsNode &operator[](int32_t index)
+	{
+		return nodes[index];
+	}
+};
+
+struct MctsReport
+{
+	long long playouts;
+	double seconds;
+	std::size_t nodes; //taken from the pool
+	int visits; //of the chosen move
+	float value; //its average result for the side to move, 0 to 1
+};
+
+Position mctsSearch(Position &position, long long playouts, int milliseconds, MctsReport &report); //the most visited move, position itself if there is none
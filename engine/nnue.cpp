@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "nnue.h"
+#include "evaluate.h"
+#include "position.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+Network network;
+
+uint64_t weightsHash(const Network &weights) //FNV-1a over everything the output depends on
+{
+	uint64_t hash = 0xCBF29CE484222325ull;
+	auto add = [&hash](const void *data, std::size_t size)
+	{
+		const unsigned char *bytes = static_cast<const unsigned char*>(data);
+		for (std::size_t i{0}; i<size; i++) hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+	};
+	add(weights.biases.data(), sizeof(weights.biases));
+	add(weights.weights.data(), sizeof(int16_t)*weights.weights.size());
+	add(weights.outputWeights.data(), sizeof(weights.outputWeights));
+	add(&weights.outputBias, sizeof(weights.outputBias));
+	add(&weights.outputScale, sizeof(weights.outputScale));
+	return hash;
+}
+
+bool loadNetwork(const std::string &path)
+{
+	std::ifstream file(path, std::ios::binary);
+	std::array<char, 4> magic;
+	std::array<uint32_t, 3> header; //version, inputs, hidden
+	if (!file.read(magic.data(), 4) || std::string(magic.data(), 4) != "CNUE") return false;
+	if (!file.read(reinterpret_cast<char*>(header.data()), sizeof(header))) return false;
+	if (header[0] != 1 || header[1] != nnueInputs || header[2] != nnueHidden) return false;
+	Network loading;
+	file.read(reinterpret_cast<char*>(loading.biases.data()), sizeof(int16_t)*nnueHidden);
+	file.read(reinterpret_cast<char*>(loading.weights.data()), sizeof(int16_t)*loading.weights.size());
+	file.read(reinterpret_cast<char*>(loading.outputWeights.data()), nnueHidden);
+	file.read(reinterpret_cast<char*>(&loading.outputBias), sizeof(int32_t));
+	file.read(reinterpret_cast<char*>(&loading.outputScale), sizeof(int32_t));
+	if (!file || loading.outputScale <= 0) return false;
+	loading.loaded = true;
+	loading.hash = weightsHash(loading);
+	network = std::move(loading);
+	return true;
+}
+
+void addColumnScalar(Accumulator &accumulator, int input)
+{
+	const int16_t *column = network.weights.data() + input*nnueHidden;
+	for (int i{0}; i<nnueHidden; i++) accumulator.values[i] += column[i];
+}
+
+void subColumnScalar(Accumulator &accumulator, int input)
+{
+	const int16_t *column = network.weights.data() + input*nnueHidden;
+	for (int i{0}; i<nnueHidden; i++) accumulator.values[i] -= column[i];
+}
+
+int32_t outputScalar(const Accumulator &accumulator)
+{
+	int32_t sum = network.outputBias;
+	for (int i{0}; i<nnueHidden; i++)
+		sum += std::clamp<int32_t>(accumulator.values[i], 0, 127) * network.outputWeights[i];
+	return sum;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("avx2")))
+void addColumnAvx2(Accumulator &accumulator, int input)
+{
+	const int16_t *column = network.weights.data() + input*nnueHidden;
+	for (int i{0}; i<nnueHidden; i+=16)
+	{
+		__m256i *values = reinterpret_cast<__m256i*>(accumulator.values.data()+i);
+		*values = _mm256_add_epi16(*values, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column+i)));
+	}
+}
+
+__attribute__((target("avx2")))
+void subColumnAvx2(Accumulator &accumulator, int input)
+{
+	const int16_t *column = network.weights.data() + input*nnueHidden;
+	for (int i{0}; i<nnueHidden; i+=16)
+	{
+		__m256i *values = reinterpret_cast<__m256i*>(accumulator.values.data()+i);
+		*values = _mm256_sub_epi16(*values, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column+i)));
+	}
+}
+
+__attribute__((target("avx2")))
+int32_t outputAvx2(const Accumulator &accumulator)
+{
+	__m256i sum = _mm256_setzero_si256();
+	for (int i{0}; i<nnueHidden; i+=32)
+	{
+		__m256i low = _mm256_load_si256(reinterpret_cast<const __m256i*>(accumulator.values.data()+i));
+		__m256i high = _mm256_load_si256(reinterpret_cast<const __m256i*>(accumulator.values.data()+i+16));
+		__m256i clipped = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8); //saturates at 255, so clamp to 127 next
+		clipped = _mm256_min_epu8(clipped, _mm256_set1_epi8(127));
+		__m256i weights = _mm256_load_si256(reinterpret_cast<const __m256i*>(network.outputWeights.data()+i));
+		sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(clipped, weights), _mm256_set1_epi16(1)));
+	}
+	__m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+	half = _mm_hadd_epi32(half, half);
+	half = _mm_hadd_epi32(half, half);
+	return network.outputBias + _mm_cvtsi128_si32(half);
+}
+#endif
+
+NnueKernels nnueKernels = []()
+{
+	NnueKernels kernels = {addColumnScalar, subColumnScalar, outputScalar};
+#if defined(__x86_64__) || defined(__i386__)
+	if (__builtin_cpu_supports("avx2")) kernels = {addColumnAvx2, subColumnAvx2, outputAvx2};
+#endif
+	return kernels;
+}();
+
+void refreshAccumulator(Accumulator &accumulator, Position &position)
+{
+	accumulator.values = network.biases;
+	for (int x{0}; x<8; x++)
+		for (int y{0}; y<8; y++)
+			if (position[x][y] != "") nnueKernels.addColumn(accumulator, pieceIndex(position[x][y])*64 + x*8+y);
+}
+
+void updateAccumulator(Accumulator &accumulator, Position &from, Position &to)
+{
+	for (int x{0}; x<8; x++)
+	{
+		for (int y{0}; y<8; y++)
+		{
+			if (from[x][y] == to[x][y]) continue;
+			if (from[x][y] != "") nnueKernels.subColumn(accumulator, pieceIndex(from[x][y])*64 + x*8+y);
+			if (to[x][y] != "") nnueKernels.addColumn(accumulator, pieceIndex(to[x][y])*64 + x*8+y);
+		}
+	}
+}
+
+bool nnueActive()
+{
+	return network.loaded && evalSettings.nnue;
+}
+
+struct NnueStack //one accumulator per ply, following the positions evaluate recurses into
+{
+	std::array<Accumulator, 128> accumulators;
+	std::array<Position*, 128> positions = {};
+	int ply = 0;
+};
+
+thread_local NnueStack nnueStack;
+
+void nnueRoot(Position &position)
+{
+	if (!nnueActive()) return;
+	nnueStack.ply = 0;
+	nnueStack.positions[0] = &position;
+	refreshAccumulator(nnueStack.accumulators[0], position);
+}
+
+void nnuePush(Position &parent, Position &child)
+{
+	if (!nnueActive()) return;
+	int ply = nnueStack.ply;
+	if (ply+1 >= static_cast<int>(nnueStack.positions.size())) return;
+	if (nnueStack.positions[ply] == &parent)
+	{
+		nnueStack.accumulators[ply+1] = nnueStack.accumulators[ply];
+		updateAccumulator(nnueStack.accumulators[ply+1], parent, child);
+	}
+	else refreshAccumulator(nnueStack.accumulators[ply+1], child);
+	nnueStack.positions[ply+1] = &child;
+	nnueStack.ply++;
+}
+
+void nnueDone()
+{
+	nnueStack.ply = 0;
+	nnueStack.positions[0] = nullptr;
+}
+
+void nnuePop()
+{
+	if (!nnueActive() || nnueStack.ply == 0) return;
+	nnueStack.positions[nnueStack.ply] = nullptr;
+	nnueStack.ply--;
+}
+
+float evaluateNnue(Position &position)
+{
+	Accumulator &accumulator = nnueStack.accumulators[nnueStack.ply];
+	if (nnueStack.positions[nnueStack.ply] != &position) //not reached through nnuePush
+	{
+		nnueStack.positions[nnueStack.ply] = &position;
+		refreshAccumulator(accumulator, position);
+	}
+	return static_cast<float>(nnueKernels.output(accumulator)) / static_cast<float>(network.outputScale);
+}
+
+void randomNetwork(std::mt19937_64 &random)
+{
+	for (int16_t &bias: network.biases) bias = static_cast<int16_t>(random()%129) - 64;
+	for (int16_t &weight: network.weights) weight = static_cast<int16_t>(random()%65) - 32;
+	for (int8_t &weight: network.outputWeights) weight = static_cast<int8_t>(static_cast<int>(random()%129) - 64);
+	network.outputBias = 0;
+	network.outputScale = 256;
+	network.loaded = true;
+	network.hash = weightsHash(network);
+}
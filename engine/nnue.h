@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "position.h"
+
+const int nnueInputs = 768; //piece index * 64 + square
+const int nnueHidden = 128;
+
+struct Network
+{
+	bool loaded = false;
+	alignas(32) std::array<int16_t, nnueHidden> biases;
+	std::vector<int16_t> weights = std::vector<int16_t>(nnueInputs*nnueHidden); //one column of nnueHidden per input
+	alignas(32) std::array<int8_t, nnueHidden> outputWeights;
+	int32_t outputBias;
+	int32_t outputScale; //output units per pawn
+	uint64_t hash = 0; //of the weights, set when they are loaded, so results kept for one network are not served to another
+};
+
+extern Network network;
+bool loadNetwork(const std::string &path);
+void randomNetwork(std::mt19937_64 &random);
+
+struct Accumulator
+{
+	alignas(32) std::array<int16_t, nnueHidden> values;
+};
+
+int32_t outputScalar(const Accumulator &accumulator); //reference the selected kernels are checked against
+
+struct NnueKernels
+{
+	void (*addColumn)(Accumulator&, int);
+	void (*subColumn)(Accumulator&, int);
+	int32_t (*output)(const Accumulator&);
+};
+
+extern NnueKernels nnueKernels;
+void refreshAccumulator(Accumulator &accumulator, Position &position);
+void updateAccumulator(Accumulator &accumulator, Position &from, Position &to);
+bool nnueActive();
+void nnueRoot(Position &position);
+void nnuePush(Position &parent, Position &child);
+void nnueDone();
+void nnuePop();
+float evaluateNnue(Position &position);
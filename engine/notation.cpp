@@ -0,0 +1,216 @@
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "notation.h"
+#include "position.h"
+
+std::string squareName(std::array<int, 2> square)
+{
+	return std::string(1, static_cast<char>('a'+square[1])) + static_cast<char>('8'-square[0]);
+}
+
+std::string moveToUci(const Move &move)
+{
+	std::string text = squareName(move.from) + squareName(move.to);
+	if (move.promotion) text += move.promotion;
+	return text;
+}
+
+const std::string startFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+bool positionFromFen(const std::string &fen, Position &position)
+{
+	std::istringstream stream(fen);
+	std::string placement, turn, castling, enPassant;
+	if (!(stream >> placement >> turn)) return false;
+	if (!(stream >> castling)) castling = "-";
+	if (!(stream >> enPassant)) enPassant = "-";
+	position = {{}, {{'l', {false, false, false}}, {'d', {false, false, false}}}, 'l', false, {0, 0}};
+	int x = 0;
+	int y = 0;
+	for (char c: placement)
+	{
+		if (c == '/')
+		{
+			x++;
+			y = 0;
+		}
+		else if ('1' <= c && c <= '8') y += c-'0';
+		else
+		{
+			char lower = static_cast<char>(std::tolower(c));
+			if (std::string("pnbrqk").find(lower) == std::string::npos || x > 7 || y > 7) return false;
+			position[x][y] = std::string(1, lower) + (std::isupper(c) ? 'l' : 'd');
+			y++;
+		}
+	}
+	if (x != 7) return false;
+	if (turn != "w" && turn != "b") return false;
+	position.turnPlayer = turn == "w" ? 'l' : 'd';
+	for (char c: castling)
+	{
+		char player = std::isupper(c) ? 'l' : 'd';
+		if (std::tolower(c) == 'k') position.castlingRights[player][2] = true;
+		if (std::tolower(c) == 'q') position.castlingRights[player][1] = true;
+	}
+	for (char player: {'l', 'd'})
+	{
+		auto &rights = position.castlingRights[player];
+		rights[0] = rights[1] || rights[2];
+	}
+	if (enPassant.size() == 2 && 'a' <= enPassant[0] && enPassant[0] <= 'h' && (enPassant[1] == '3' || enPassant[1] == '6'))
+	{
+		position.enPassantAllowed = true;
+		position.enPassantSquare = {'8'-enPassant[1], enPassant[0]-'a'};
+	}
+	return true;
+}
+
+std::string fenFromPosition(Position &position, int halfmoves, int fullmoves)
+{
+	std::string fen = "";
+	for (int x{0}; x<8; x++)
+	{
+		int empty = 0;
+		for (int y{0}; y<8; y++)
+		{
+			if (position[x][y] == "")
+			{
+				empty++;
+				continue;
+			}
+			if (empty) fen += static_cast<char>('0'+empty);
+			empty = 0;
+			char piece = position[x][y][0];
+			fen += position[x][y][1] == 'l' ? static_cast<char>(std::toupper(piece)) : piece;
+		}
+		if (empty) fen += static_cast<char>('0'+empty);
+		if (x < 7) fen += '/';
+	}
+	fen += position.turnPlayer == 'l' ? " w " : " b ";
+	std::string castling = "";
+	if (position.castlingRights['l'][0] && position.castlingRights['l'][2]) castling += 'K';
+	if (position.castlingRights['l'][0] && position.castlingRights['l'][1]) castling += 'Q';
+	if (position.castlingRights['d'][0] && position.castlingRights['d'][2]) castling += 'k';
+	if (position.castlingRights['d'][0] && position.castlingRights['d'][1]) castling += 'q';
+	fen += castling == "" ? "-" : castling;
+	fen += " " + (position.enPassantAllowed ? squareName(position.enPassantSquare) : "-");
+	return fen + " " + std::to_string(halfmoves) + " " + std::to_string(fullmoves);
+}
+
+std::string moveToSan(Position &before, Position &after)
+{
+	Move move = moveBetween(before, after);
+	std::string piece = before[move.from[0]][move.from[1]];
+	std::string san = "";
+	if (piece[0] == 'k' && std::abs(move.to[1] - move.from[1]) == 2)
+	{
+		san = move.to[1] > move.from[1] ? "O-O" : "O-O-O";
+	}
+	else
+	{
+		bool capture = before[move.to[0]][move.to[1]] != "" || (piece[0] == 'p' && move.from[1] != move.to[1]);
+		if (piece[0] == 'p')
+		{
+			if (capture) san += static_cast<char>('a'+move.from[1]);
+		}
+		else
+		{
+			san += static_cast<char>(std::toupper(piece[0]));
+			bool sameFile = false;
+			bool sameRank = false;
+			bool ambiguous = false;
+			for (Position &other: legalMoves(before))
+			{
+				Move otherMove = moveBetween(before, other);
+				if (otherMove.to != move.to || otherMove.from == move.from) continue;
+				if (before[otherMove.from[0]][otherMove.from[1]] != piece) continue;
+				ambiguous = true;
+				if (otherMove.from[1] == move.from[1]) sameFile = true;
+				if (otherMove.from[0] == move.from[0]) sameRank = true;
+			}
+			if (ambiguous && !sameFile) san += static_cast<char>('a'+move.from[1]);
+			else if (ambiguous && !sameRank) san += static_cast<char>('8'-move.from[0]);
+			else if (ambiguous) san += squareName(move.from);
+		}
+		if (capture) san += 'x';
+		san += squareName(move.to);
+		if (move.promotion) san += std::string("=") + static_cast<char>(std::toupper(move.promotion));
+	}
+	after.toggleTurn();
+	bool check = isCheck(after);
+	after.toggleTurn();
+	if (check) san += legalMoves(after).empty() ? "#" : "+";
+	return san;
+}
+
+bool sanToPosition(Position &position, std::string san, Position &result)
+{
+	while (!san.empty() && std::string("+#!?").find(san.back()) != std::string::npos) san.pop_back();
+	if (san.size() < 2) return false;
+	char piece = 'p';
+	char promotion = 0;
+	int castle = 0; //2 kingside, -2 queenside
+	int fromFile = -1;
+	int fromRank = -1;
+	std::array<int, 2> to = {-1, -1};
+	if (san == "O-O" || san == "0-0") castle = 2;
+	else if (san == "O-O-O" || san == "0-0-0") castle = -2;
+	else
+	{
+		if (std::string("NBRQK").find(san[0]) != std::string::npos)
+		{
+			piece = static_cast<char>(std::tolower(san[0]));
+			san.erase(0, 1);
+		}
+		auto equals = san.find('=');
+		if (equals != std::string::npos && equals+1 < san.size())
+		{
+			promotion = static_cast<char>(std::tolower(san[equals+1]));
+			san.erase(equals);
+		}
+		else if (piece == 'p' && std::string("NBRQ").find(san.back()) != std::string::npos)
+		{
+			promotion = static_cast<char>(std::tolower(san.back()));
+			san.pop_back();
+		}
+		san.erase(std::remove(san.begin(), san.end(), 'x'), san.end());
+		if (san.size() < 2) return false;
+		char file = san[san.size()-2];
+		char rank = san[san.size()-1];
+		if (file < 'a' || file > 'h' || rank < '1' || rank > '8') return false;
+		to = {'8'-rank, file-'a'};
+		for (std::size_t i{0}; i+2<san.size(); i++)
+		{
+			if ('a' <= san[i] && san[i] <= 'h') fromFile = san[i]-'a';
+			else if ('1' <= san[i] && san[i] <= '8') fromRank = '8'-san[i];
+			else return false;
+		}
+	}
+	int matches = 0;
+	MoveGenerator moveGenerator = {position, false};
+	for (Position move = moveGenerator.next(); !moveGenerator.done; move = moveGenerator.next())
+	{
+		Move candidate = moveBetween(position, move);
+		char moving = position[candidate.from[0]][candidate.from[1]][0];
+		if (castle)
+		{
+			if (moving != 'k' || candidate.to[1] - candidate.from[1] != castle) continue;
+		}
+		else
+		{
+			if (moving != piece || candidate.to != to || candidate.promotion != promotion) continue;
+			if (piece == 'k' && std::abs(candidate.to[1] - candidate.from[1]) == 2) continue;
+			if (fromFile != -1 && candidate.from[1] != fromFile) continue;
+			if (fromRank != -1 && candidate.from[0] != fromRank) continue;
+		}
+		result = move;
+		matches++;
+	}
+	return matches == 1;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <array>
+#include <string>
+
+#include "position.h"
+
+std::string squareName(std::array<int, 2> square);
+std::string moveToUci(const Move &move);
+extern const std::string startFen;
+bool positionFromFen(const std::string &fen, Position &position);
+std::string fenFromPosition(Position &position, int halfmoves = 0, int fullmoves = 1);
+std::string moveToSan(Position &before, Position &after);
+bool sanToPosition(Position &position, std::string san, Position &result);
@@ -0,0 +1,42 @@
+#include <algorithm>
+#include <vector>
+
+#include "perft.h"
+#include "position.h"
+
+long long perft(Position &position, int depth, PerftHash &hash)
+{
+	if (depth == 0) return 1;
+	uint64_t key = 0;
+	long long count = 0;
+	if (depth >= 2)
+	{
+		key = positionKey(position);
+		if (hash.probe(key, depth, count)) return count;
+	}
+	MoveGenerator moveGenerator = {position, false};
+	for (Position move = moveGenerator.next(); !moveGenerator.done; move = moveGenerator.next())
+		count += depth == 1 ? 1 : perft(move, depth-1, hash);
+	if (depth >= 2) hash.store(key, depth, count);
+	return count;
+}
+
+long long parallelPerft(Position &root, int depth, int splitDepth, int threads, PerftHash &hash)
+{
+	WorkStealingPool pool(threads);
+	std::atomic<long long> nodes{0};
+	std::function<void(int, Position, int)> split = [&](int worker, Position position, int remaining)
+	{
+		if (remaining <= depth - splitDepth || remaining <= 1)
+		{
+			nodes += perft(position, remaining, hash);
+			return;
+		}
+		MoveGenerator moveGenerator = {position, false};
+		for (Position move = moveGenerator.next(); !moveGenerator.done; move = moveGenerator.next())
+			pool.push(worker, [&split, move, remaining](int id) { split(id, move, remaining-1); });
+	};
+	pool.push(0, [&](int id) { split(id, root, depth); });
+	pool.run();
+	return nodes;
+}
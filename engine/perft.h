@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "position.h"
+
+struct PerftHash //lockless: an entry is only trusted if its check word matches the key it was stored under
+{
+	struct Entry
+	{
+		std::atomic<uint64_t> check{0};
+		std::atomic<uint64_t> data{0}; //count << 8 | depth
+	};
+	std::vector<Entry> entries;
+	PerftHash(std::size_t megabytes)
+	{
+		std::size_t size = 1;
+		while (size * 2 * sizeof(Entry) <= megabytes << 20) size *= 2;
+		entries = std::vector<Entry>(megabytes ? size : 0);
+	}
+	bool probe(uint64_t key, int depth, long long &count)
+	{
+		if (entries.empty()) return false;
+		Entry &entry = entries[key & (entries.size()-1)];
+		uint64_t data = entry.data.load(std::memory_order_relaxed);
+		if ((entry.check.load(std::memory_order_relaxed) ^ data) != key || static_cast<int>(data & 0xFF) != depth) return false;
+		count = static_cast<long long>(data >> 8);
+		return true;
+	}
+	void store(uint64_t key, int depth, long long count)
+	{
+		if (entries.empty()) return;
+		Entry &entry = entries[key & (entries.size()-1)];
+		uint64_t data = static_cast<uint64_t>(count) << 8 | static_cast<uint64_t>(depth);
+		entry.check.store(key ^ data, std::memory_order_relaxed);
+		entry.data.store(data, std::memory_order_relaxed);
+	}
+};
+
+long long perft(Position &position, int depth, PerftHash &hash);
+
+struct WorkStealingPool //each worker pops its own newest task and steals the oldest from the others
+{
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<std::function<void(int)>> tasks;
+	};
+	std::vector<Queue> queues;
+	std::atomic<long long> pending{0};
+	WorkStealingPool(int threads) : queues(threads) {}
+	void push(int worker, std::function<void(int)> task)
+	{
+		pending++;
+		std::lock_guard<std::mutex> lock(queues[worker].mutex);
+		queues[worker].tasks.push_back(std::move(task));
+	}
+	bool take(int worker, std::function<void(int)> &task)
+	{
+		{
+			std::lock_guard<std::mutex> lock(queues[worker].mutex);
+			if (!queues[worker].tasks.empty())
+			{
+				task = std::move(queues[worker].tasks.back());
+				queues[worker].tasks.pop_back();
+				return true;
+			}
+		}
+		for (std::size_t i{1}; i<queues.size(); i++)
+		{
+			Queue &victim = queues[(worker+i) % queues.size()];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (!victim.tasks.empty())
+			{
+				task = std::move(victim.tasks.front());
+				victim.tasks.pop_front();
+				return true;
+			}
+		}
+		return false;
+	}
+	void run()
+	{
+		auto worker = [this](int id)
+		{
+			std::function<void(int)> task;
+			while (pending > 0)
+			{
+				if (!take(id, task))
+				{
+					std::this_thread::yield();
+					continue;
+				}
+				task(id);
+				pending--;
+			}
+		};
+		std::vector<std::thread> threads = {};
+		for (std::size_t id{1}; id<queues.size(); id++) threads.emplace_back(worker, static_cast<int>(id));
+		worker(0);
+		for (std::thread &thread: threads) thread.join();
+	}
+};
+
+long long parallelPerft(Position &root, int depth, int splitDepth, int threads, PerftHash &hash);
@@ -0,0 +1,49 @@
+#include <algorithm>
+#include <ctime>
+#include <sstream>
+#include <string>
+
+#include "pgn.h"
+#include "notation.h"
+#include "position.h"
+
+std::string gameToPgn(GameRecord &record, const std::string &event, int round, const std::string &white, const std::string &black)
+{
+	std::time_t now = std::time(nullptr);
+	char date[16];
+	std::strftime(date, sizeof(date), "%Y.%m.%d", std::localtime(&now));
+	std::string pgn = "[Event \"" + event + "\"]\n[Site \"?\"]\n[Date \"" + date + "\"]\n[Round \"" + std::to_string(round)
+	+ "\"]\n[White \"" + white + "\"]\n[Black \"" + black + "\"]\n[Result \"" + record.result + "\"]\n";
+	if (record.fen != startFen) pgn += "[SetUp \"1\"]\n[FEN \"" + record.fen + "\"]\n";
+	if (record.termination != "") pgn += "[Termination \"" + record.termination + "\"]\n";
+	pgn += "\n";
+
+	Position position;
+	positionFromFen(record.fen, position);
+	int fullmove = 1;
+	std::istringstream fields(record.fen);
+	std::string field;
+	for (int i{0}; i<6 && fields >> field; i++)
+		if (i == 5) fullmove = std::max(std::stoi(field), 1);
+	bool lightToMove = position.turnPlayer == 'l';
+	std::string line = "";
+	auto append = [&](const std::string &token)
+	{
+		if (line.size() + token.size() + 1 > 79)
+		{
+			pgn += line + "\n";
+			line = "";
+		}
+		line += (line == "" ? "" : " ") + token;
+	};
+	for (std::size_t i{0}; i<record.moves.size(); i++)
+	{
+		if (lightToMove) append(std::to_string(fullmove) + ".");
+		else if (i == 0) append(std::to_string(fullmove) + "...");
+		append(record.moves[i]);
+		if (!lightToMove) fullmove++;
+		lightToMove = !lightToMove;
+	}
+	append(record.result);
+	return pgn + line + "\n\n";
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <array>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "position.h"
+
+struct GameRecord
+{
+	std::string fen;
+	std::vector<std::string> moves; //SAN
+	std::string result; //1-0, 0-1 or 1/2-1/2
+	std::string termination;
+};
+
+std::string gameToPgn(GameRecord &record, const std::string &event, int round, const std::string &white, const std::string &black);
+
+struct PgnGame //reused between games so reading does not allocate once capacities have grown
+{
+	std::vector<std::array<std::string, 2>> tags;
+	int tagCount = 0;
+	std::vector<std::string> moves; //SAN
+	int moveCount = 0;
+	std::string result;
+	void clear()
+	{
+		tagCount = 0;
+		moveCount = 0;
+		result.clear();
+	}
+	std::string &newTag()
+	{
+		if (tagCount == static_cast<int>(tags.size())) tags.emplace_back();
+		tags[tagCount][1].clear();
+		return tags[tagCount++][0];
+	}
+	void addMove(const std::string &move)
+	{
+		if (moveCount == static_cast<int>(moves.size())) moves.emplace_back();
+		moves[moveCount++].assign(move);
+	}
+	std::string tag(const std::string &name) const
+	{
+		for (int i{0}; i<tagCount; i++)
+			if (tags[i][0] == name) return tags[i][1];
+		return "";
+	}
+};
+
+struct PgnReader //streams games from a file of any size through a fixed buffer
+{
+	std::FILE *file;
+	std::vector<char> buffer;
+	std::size_t position = 0;
+	std::size_t size = 0;
+	int pushedBack = EOF;
+	std::string token;
+	PgnReader(const std::string &path, std::size_t chunkSize = 1 << 20)
+	{
+		file = std::fopen(path.c_str(), "rb");
+		buffer.resize(chunkSize);
+	}
+	~PgnReader()
+	{
+		if (file) std::fclose(file);
+	}
+	bool open()
+	{
+		return file != nullptr;
+	}
+	int get()
+	{
+		if (pushedBack != EOF)
+		{
+			int c = pushedBack;
+			pushedBack = EOF;
+			return c;
+		}
+		if (position == size)
+		{
+			size = file ? std::fread(buffer.data(), 1, buffer.size(), file) : 0;
+			position = 0;
+			if (size == 0) return EOF;
+		}
+		return static_cast<unsigned char>(buffer[position++]);
+	}
+	void skipUntil(char end)
+	{
+		for (int c = get(); c != EOF && c != end; c = get());
+	}
+	bool next(PgnGame &game)
+	{
+		game.clear();
+		bool inMoves = false;
+		for (int c = get(); c != EOF; c = get())
+		{
+			if (std::isspace(c)) continue;
+			if (c == '[')
+			{
+				if (inMoves) //a new game began without a result
+				{
+					pushedBack = c;
+					return true;
+				}
+				std::string &name = game.newTag();
+				name.clear();
+				for (c = get(); c != EOF && !std::isspace(c) && c != ']'; c = get()) name += static_cast<char>(c);
+				while (c != EOF && c != '"' && c != ']') c = get();
+				std::string &value = game.tags[game.tagCount-1][1];
+				if (c == '"')
+				{
+					for (c = get(); c != EOF && c != '"'; c = get())
+					{
+						if (c == '\\') c = get();
+						if (c != EOF) value += static_cast<char>(c);
+					}
+				}
+				if (c != ']') skipUntil(']');
+			}
+			else if (c == '{') skipUntil('}');
+			else if (c == ';' || c == '%') skipUntil('\n');
+			else if (c == '(')
+			{
+				int depth = 1;
+				for (c = get(); c != EOF && depth > 0; c = get())
+				{
+					if (c == '(') depth++;
+					if (c == ')') depth--;
+					if (c == '{') skipUntil('}');
+					if (depth == 0) break;
+				}
+			}
+			else if (c == '$') for (c = get(); c != EOF && std::isdigit(c); c = get());
+			else
+			{
+				inMoves = true;
+				token.clear();
+				for (; c != EOF && !std::isspace(c) && std::string("{}()[];").find(static_cast<char>(c)) == std::string::npos; c = get())
+					token += static_cast<char>(c);
+				if (c != EOF && !std::isspace(c)) pushedBack = c;
+				if (token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*")
+				{
+					game.result = token;
+					return true;
+				}
+				std::size_t start = 0;
+				if (token != "0-0" && token != "0-0-0")
+				{
+					while (start < token.size() && std::isdigit(static_cast<unsigned char>(token[start]))) start++;
+					while (start < token.size() && token[start] == '.') start++;
+				}
+				if (start < token.size()) game.addMove(token.substr(start));
+			}
+		}
+		return game.moveCount > 0 || game.tagCount > 0;
+	}
+};
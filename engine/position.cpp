@@ -0,0 +1,583 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "position.h"
+
+void updateNewPosition(Position &newPosition, int x, int y, int i, int j)
+{
+	newPosition[x+i][y+j] = "";
+	std::swap(newPosition[x+i][y+j], newPosition[x][y]);
+	if (newPosition[0][4] != "kd") newPosition.castlingRights['d'][0] = false; 
+	if (newPosition[0][0] != "rd") newPosition.castlingRights['d'][1] = false;
+	if (newPosition[0][7] != "rd") newPosition.castlingRights['d'][2] = false;
+	if (newPosition[7][4] != "kl") newPosition.castlingRights['l'][0] = false;  
+	if (newPosition[7][0] != "rl") newPosition.castlingRights['l'][1] = false;
+	if (newPosition[7][7] != "rl") newPosition.castlingRights['l'][2] = false; 
+	newPosition.enPassantAllowed = false;
+	newPosition.toggleTurn();
+}
+
+constexpr std::array<std::array<int, 2>, 4> rookDirections = {{{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
+constexpr std::array<std::array<int, 2>, 4> bishopDirections = {{{1, 1}, {-1, -1}, {1, -1}, {-1, 1}}};
+
+struct StepTable //squares a leaping piece reaches from every square, in step order
+{
+	std::array<std::array<std::array<int8_t, 2>, 8>, 64> targets;
+	std::array<int8_t, 64> count;
+};
+
+constexpr StepTable makeStepTable(const std::array<std::array<int, 2>, 8> &steps)
+{
+	StepTable table = {};
+	for (int square = 0; square < 64; square++)
+	{
+		for (const std::array<int, 2> &step: steps)
+		{
+			int x = square/8 + step[0];
+			int y = square%8 + step[1];
+			if (x < 0 || x > 7 || y < 0 || y > 7) continue;
+			table.targets[square][table.count[square]++] = {static_cast<int8_t>(x), static_cast<int8_t>(y)};
+		}
+	}
+	return table;
+}
+
+constexpr StepTable knightTable = makeStepTable({{{1, 2}, {2, 1}, {-1, 2}, {2, -1}, {1, -2}, {-2, 1}, {-1, -2}, {-2, -1}}});
+constexpr StepTable kingTable = makeStepTable({{{1, 1}, {1, 0}, {1, -1}, {0, 1}, {0, -1}, {-1, 1}, {-1, 0}, {-1, -1}}});
+
+constexpr uint64_t squareBit(int x, int y)
+{
+	return 1ull << (x*8+y);
+}
+
+template <char Them>
+bool attacked(const Position &position, int x, int y)
+{
+	for (const std::array<int, 2> &direction: rookDirections)
+	{
+		for (int i = x+direction[0], j = y+direction[1]; i >= 0 && i < 8 && j >= 0 && j < 8; i += direction[0], j += direction[1])
+		{
+			const std::string &square = position[i][j];
+			if (square == "") continue;
+			if (square[1] == Them && (square[0] == 'r' || square[0] == 'q')) return true;
+			break;
+		}
+	}
+	for (const std::array<int, 2> &direction: bishopDirections)
+	{
+		for (int i = x+direction[0], j = y+direction[1]; i >= 0 && i < 8 && j >= 0 && j < 8; i += direction[0], j += direction[1])
+		{
+			const std::string &square = position[i][j];
+			if (square == "") continue;
+			if (square[1] == Them && (square[0] == 'b' || square[0] == 'q')) return true;
+			break;
+		}
+	}
+	for (int n{0}; n<knightTable.count[x*8+y]; n++)
+	{
+		const std::string &square = position[knightTable.targets[x*8+y][n][0]][knightTable.targets[x*8+y][n][1]];
+		if (square != "" && square[1] == Them && square[0] == 'n') return true;
+	}
+	for (int n{0}; n<kingTable.count[x*8+y]; n++)
+	{
+		const std::string &square = position[kingTable.targets[x*8+y][n][0]][kingTable.targets[x*8+y][n][1]];
+		if (square != "" && square[1] == Them && square[0] == 'k') return true;
+	}
+	constexpr int pawnRow = Them == 'l' ? 1 : -1; //Them's pawns attack from behind the square, seen from Them
+	if (x+pawnRow < 0 || x+pawnRow > 7) return false;
+	for (int j{y-1}; j<=y+1; j+=2)
+	{
+		if (j < 0 || j > 7) continue;
+		const std::string &square = position[x+pawnRow][j];
+		if (square != "" && square[1] == Them && square[0] == 'p') return true;
+	}
+	return false;
+}
+
+template <char Them>
+int findCheckers(const Position &position, int x, int y, uint64_t &evasionTargets) //squares a non-king move must reach to answer the check
+{
+	int checkers = 0;
+	evasionTargets = 0;
+	for (int slider{0}; slider<2; slider++)
+	{
+		const auto &directions = slider == 0 ? rookDirections : bishopDirections;
+		char piece = slider == 0 ? 'r' : 'b';
+		for (const std::array<int, 2> &direction: directions)
+		{
+			uint64_t line = 0;
+			for (int i = x+direction[0], j = y+direction[1]; i >= 0 && i < 8 && j >= 0 && j < 8; i += direction[0], j += direction[1])
+			{
+				const std::string &square = position[i][j];
+				line |= squareBit(i, j);
+				if (square == "") continue;
+				if (square[1] == Them && (square[0] == piece || square[0] == 'q'))
+				{
+					checkers++;
+					evasionTargets |= line;
+				}
+				break;
+			}
+		}
+	}
+	for (const StepTable *table: {&knightTable, &kingTable})
+	{
+		for (int n{0}; n<table->count[x*8+y]; n++)
+		{
+			int i = table->targets[x*8+y][n][0];
+			int j = table->targets[x*8+y][n][1];
+			const std::string &square = position[i][j];
+			if (square != "" && square[1] == Them && square[0] == (table == &knightTable ? 'n' : 'k'))
+			{
+				checkers++;
+				evasionTargets |= squareBit(i, j);
+			}
+		}
+	}
+	constexpr int pawnRow = Them == 'l' ? 1 : -1;
+	for (int j{y-1}; j<=y+1 && x+pawnRow >= 0 && x+pawnRow < 8; j+=2)
+	{
+		if (j < 0 || j > 7) continue;
+		const std::string &square = position[x+pawnRow][j];
+		if (square != "" && square[1] == Them && square[0] == 'p')
+		{
+			checkers++;
+			evasionTargets |= squareBit(x+pawnRow, j);
+		}
+	}
+	return checkers;
+}
+
+template <char Us, GenType Type>
+int generateMoves(const Position &position, GenMove *moves, uint64_t evasionTargets) //in the order squares and directions were always scanned
+{
+	constexpr char Them = Us == 'l' ? 'd' : 'l';
+	constexpr bool captures = Type != GenType::quiets;
+	constexpr bool quiets = Type != GenType::captures;
+	constexpr int forward = Us == 'l' ? -1 : 1;
+	constexpr int startRow = Us == 'l' ? 6 : 1;
+	constexpr int lastRow = Us == 'l' ? 0 : 7;
+	int count = 0;
+	auto add = [&](int x, int y, int i, int j, uint8_t flags)
+	{
+		if (count < maxMoves) moves[count++] = {static_cast<int8_t>(x), static_cast<int8_t>(y), static_cast<int8_t>(i), static_cast<int8_t>(j), flags};
+	};
+	auto allowed = [&](int i, int j)
+	{
+		return Type != GenType::evasions || (evasionTargets & squareBit(i, j));
+	};
+	auto slide = [&](int x, int y, const std::array<std::array<int, 2>, 4> &directions)
+	{
+		for (const std::array<int, 2> &direction: directions)
+		{
+			for (int i = x+direction[0], j = y+direction[1]; i >= 0 && i < 8 && j >= 0 && j < 8; i += direction[0], j += direction[1])
+			{
+				const std::string &square = position[i][j];
+				if (square == "")
+				{
+					if (quiets && allowed(i, j)) add(x, y, i, j, 0);
+					continue;
+				}
+				if (captures && square[1] != Us && allowed(i, j)) add(x, y, i, j, 0);
+				break;
+			}
+		}
+	};
+	auto leap = [&](int x, int y, const StepTable &table, bool king)
+	{
+		for (int n{0}; n<table.count[x*8+y]; n++)
+		{
+			int i = table.targets[x*8+y][n][0];
+			int j = table.targets[x*8+y][n][1];
+			const std::string &square = position[i][j];
+			if (!king && !allowed(i, j)) continue;
+			if (square == "" ? quiets : captures && square[1] != Us) add(x, y, i, j, 0);
+		}
+	};
+
+	for (int y{0}; y<8; y++)
+	{
+		for (int x{0}; x<8; x++)
+		{
+			const std::string &piece = position[x][y];
+			if (piece == "" || piece[1] != Us) continue;
+			if (Type == GenType::evasions && evasionTargets == 0 && piece[0] != 'k') continue; //double check
+			switch (piece[0])
+			{
+				case 'r': slide(x, y, rookDirections); break;
+				case 'b': slide(x, y, bishopDirections); break;
+				case 'q':
+					slide(x, y, rookDirections);
+					slide(x, y, bishopDirections);
+					break;
+				case 'n': leap(x, y, knightTable, false); break;
+				case 'k':
+				{
+					leap(x, y, kingTable, true);
+					const std::array<bool, 3> &rights = position.castlingRights[Us];
+					if (!quiets || !rights[0]) break;
+					if (rights[2] && y+3 <= 7 && position[x][y+1] == "" && position[x][y+2] == "")
+						add(x, y, x, y+2, GenMove::castleKingside);
+					if (rights[1] && y-4 >= 0 && position[x][y-1] == "" && position[x][y-2] == "" && position[x][y-3] == "")
+						add(x, y, x, y-2, GenMove::castleQueenside);
+					break;
+				}
+				case 'p':
+				{
+					int ahead = x+forward;
+					if (ahead < 0 || ahead > 7) break;
+					uint8_t promotion = ahead == lastRow ? GenMove::promotion : 0;
+					if (quiets && x == startRow && position[ahead][y] == "" && position[ahead+forward][y] == "" && allowed(ahead+forward, y))
+						add(x, y, ahead+forward, y, GenMove::doublePush);
+					if (quiets && position[ahead][y] == "" && allowed(ahead, y))
+						add(x, y, ahead, y, promotion);
+					for (int j{y-1}; j<=y+1; j+=2)
+					{
+						if (captures && j >= 0 && j <= 7 && position[ahead][j] != "" && position[ahead][j][1] == Them && allowed(ahead, j))
+							add(x, y, ahead, j, promotion);
+					}
+					for (int j{y-1}; j<=y+1; j+=2)
+					{
+						if (captures && position.enPassantAllowed && position.enPassantSquare[0] == ahead && position.enPassantSquare[1] == j
+						&& (allowed(ahead, j) || allowed(x, j)))
+							add(x, y, ahead, j, GenMove::enPassant);
+					}
+					break;
+				}
+			}
+		}
+	}
+	return count;
+}
+
+template <char Us>
+void applyMove(Position &newPosition, const GenMove &move)
+{
+	int x = move.fromX;
+	int y = move.fromY;
+	if (move.flags & GenMove::castleKingside) std::swap(newPosition[x][y+1], newPosition[x][y+3]);
+	if (move.flags & GenMove::castleQueenside) std::swap(newPosition[x][y-1], newPosition[x][y-4]);
+	if (move.flags & GenMove::promotion) newPosition[x][y] = Us == 'l' ? "ql" : "qd";
+	updateNewPosition(newPosition, x, y, move.toX-x, move.toY-y);
+	if (move.flags & GenMove::doublePush)
+	{
+		newPosition.enPassantAllowed = true;
+		newPosition.enPassantSquare = {(x+move.toX)/2, y};
+	}
+	if (move.flags & GenMove::enPassant) newPosition[x][move.toY] = "";
+}
+
+template <char Us>
+bool findKing(const Position &position, int &x, int &y)
+{
+	for (x = 0; x < 8; x++)
+		for (y = 0; y < 8; y++)
+			if (position[x][y] != "" && position[x][y][0] == 'k' && position[x][y][1] == Us) return true;
+	return false;
+}
+
+template <char Us>
+int generate(const Position &position, GenType type, GenMove *moves)
+{
+	constexpr char Them = Us == 'l' ? 'd' : 'l';
+	switch (type)
+	{
+		case GenType::all: return generateMoves<Us, GenType::all>(position, moves, 0);
+		case GenType::captures: return generateMoves<Us, GenType::captures>(position, moves, 0);
+		case GenType::quiets: return generateMoves<Us, GenType::quiets>(position, moves, 0);
+		case GenType::evasions: break;
+	}
+	int x;
+	int y;
+	uint64_t evasionTargets;
+	int checkers = findKing<Us>(position, x, y) ? findCheckers<Them>(position, x, y, evasionTargets) : 0;
+	if (checkers == 0) return generateMoves<Us, GenType::all>(position, moves, 0);
+	return generateMoves<Us, GenType::evasions>(position, moves, checkers > 1 ? 0 : evasionTargets); //0 targets for a double check
+}
+
+int pieceValue(char piece)
+{
+	switch (piece)
+	{
+		case 'p': return 100;
+		case 'n': return 300;
+		case 'b': return 300;
+		case 'r': return 500;
+		case 'q': return 900;
+		case 'k': return 20000;
+	}
+	return 0;
+}
+
+bool leastValuableAttacker(const Position &position, uint64_t occupied, char side, int x, int y, int &fromX, int &fromY) //sliders see through pieces already taken off occupied
+{
+	auto is = [&](int i, int j, char piece)
+	{
+		return (occupied & squareBit(i, j)) && position[i][j][0] == piece && position[i][j][1] == side;
+	};
+	int pawnRow = x + (side == 'l' ? 1 : -1);
+	for (int j{y-1}; j<=y+1 && pawnRow >= 0 && pawnRow < 8; j+=2)
+	{
+		if (j < 0 || j > 7 || !is(pawnRow, j, 'p')) continue;
+		fromX = pawnRow;
+		fromY = j;
+		return true;
+	}
+	for (int n{0}; n<knightTable.count[x*8+y]; n++)
+	{
+		fromX = knightTable.targets[x*8+y][n][0];
+		fromY = knightTable.targets[x*8+y][n][1];
+		if (is(fromX, fromY, 'n')) return true;
+	}
+	auto slide = [&](const std::array<std::array<int, 2>, 4> &directions, char piece)
+	{
+		for (const std::array<int, 2> &direction: directions)
+		{
+			for (int i = x+direction[0], j = y+direction[1]; i >= 0 && i < 8 && j >= 0 && j < 8; i += direction[0], j += direction[1])
+			{
+				if (!(occupied & squareBit(i, j))) continue;
+				if (!is(i, j, piece)) break;
+				fromX = i;
+				fromY = j;
+				return true;
+			}
+		}
+		return false;
+	};
+	if (slide(bishopDirections, 'b') || slide(rookDirections, 'r')) return true;
+	if (slide(bishopDirections, 'q') || slide(rookDirections, 'q')) return true;
+	for (int n{0}; n<kingTable.count[x*8+y]; n++)
+	{
+		fromX = kingTable.targets[x*8+y][n][0];
+		fromY = kingTable.targets[x*8+y][n][1];
+		if (is(fromX, fromY, 'k')) return true;
+	}
+	return false;
+}
+
+int staticExchange(const Position &position, const Move &move)
+{
+	uint64_t occupied = 0;
+	for (int x{0}; x<8; x++)
+		for (int y{0}; y<8; y++)
+			if (position[x][y] != "") occupied |= squareBit(x, y);
+	int x = move.to[0];
+	int y = move.to[1];
+	const std::string &mover = position[move.from[0]][move.from[1]];
+	bool enPassant = mover[0] == 'p' && move.from[1] != y && position[x][y] == "";
+	std::array<int, 32> gain; //gain[d] is what the side making capture d nets if the exchange stops after it
+	gain[0] = enPassant ? pieceValue('p') : position[x][y] == "" ? 0 : pieceValue(position[x][y][0]);
+	if (enPassant) occupied &= ~squareBit(move.from[0], y);
+	occupied &= ~squareBit(move.from[0], move.from[1]);
+	char onSquare = mover[0];
+	char side = mover[1] == 'l' ? 'd' : 'l';
+	int depth = 0;
+	int fromX;
+	int fromY;
+	while (depth+1 < static_cast<int>(gain.size()) && leastValuableAttacker(position, occupied, side, x, y, fromX, fromY))
+	{
+		depth++;
+		gain[depth] = pieceValue(onSquare) - gain[depth-1];
+		onSquare = position[fromX][fromY][0];
+		occupied &= ~squareBit(fromX, fromY);
+		side = side == 'l' ? 'd' : 'l';
+	}
+	for (; depth>0; depth--) gain[depth-1] = -std::max(-gain[depth-1], gain[depth]); //either side may stop recapturing
+	return gain[0];
+}
+
+MoveGenerator::MoveGenerator(Position _position, bool _ignoreCheck, GenType type)
+{
+	position = _position;
+	ignoreCheck = _ignoreCheck;
+	if (!ignoreCheck && type == GenType::all) type = GenType::evasions; //same legal moves, fewer to reject when in check
+	count = position.turnPlayer == 'l' ? generate<'l'>(position, type, moves.data()) : generate<'d'>(position, type, moves.data());
+	index = 0;
+	done = false;
+}
+
+void MoveGenerator::orderCaptures()
+{
+	std::array<GenMove, maxMoves> sorted;
+	std::array<int16_t, maxMoves> values;
+	std::array<int8_t, maxMoves> group; //0 winning or even capture, 1 quiet, 2 losing capture
+	for (int i{0}; i<count; i++)
+	{
+		const GenMove &move = moves[i];
+		bool capture = position[move.toX][move.toY] != "" || (move.flags & GenMove::enPassant);
+		values[i] = capture ? static_cast<int16_t>(staticExchange(position, {{move.fromX, move.fromY}, {move.toX, move.toY}, '\0'})) : 0;
+		group[i] = !capture ? 1 : values[i] >= 0 ? 0 : 2;
+	}
+	int size = 0;
+	for (int8_t current{0}; current<3; current++)
+	{
+		int start = size;
+		for (int i{0}; i<count; i++)
+		{
+			if (group[i] != current) continue;
+			int j = size++; //stable insertion by value, which only captures have
+			while (j > start && exchange[j-1] < values[i])
+			{
+				sorted[j] = sorted[j-1];
+				exchange[j] = exchange[j-1];
+				j--;
+			}
+			sorted[j] = moves[i];
+			exchange[j] = values[i];
+		}
+	}
+	std::copy(sorted.begin(), sorted.begin()+count, moves.begin());
+	ordered = true;
+}
+
+Position MoveGenerator::next()
+{
+	while (index < count)
+	{
+		const GenMove &move = moves[index];
+		Position newPosition = position;
+		lastCapture = position[move.toX][move.toY] != "" || (move.flags & GenMove::enPassant);
+		lastExchange = ordered ? exchange[index] : 0;
+		index++;
+		if (position.turnPlayer == 'l') applyMove<'l'>(newPosition, move);
+		else applyMove<'d'>(newPosition, move);
+		if (ignoreCheck || !isCheck(newPosition)) return newPosition;
+	}
+	done = true;
+	return Position();
+}
+
+void playMove(Position &position, const GenMove &move)
+{
+	if (position.turnPlayer == 'l') applyMove<'l'>(position, move);
+	else applyMove<'d'>(position, move);
+}
+
+bool isCheck(const Position &position)
+{
+	int x;
+	int y;
+	if (position.turnPlayer == 'd')
+	{
+		if (!findKing<'l'>(position, x, y)) return true;
+		return attacked<'d'>(position, x, y);
+	}
+	if (!findKing<'d'>(position, x, y)) return true;
+	return attacked<'l'>(position, x, y);
+}
+
+Move moveBetween(Position &before, Position &after)
+{
+	Move move = {{-1, -1}, {-1, -1}, 0};
+	char player = before.turnPlayer;
+	for (int x{0}; x<8; x++)
+	{
+		for (int y{0}; y<8; y++)
+		{
+			bool vacated = before[x][y] != "" && before[x][y][1] == player && after[x][y] != before[x][y];
+			bool arrived = after[x][y] != "" && after[x][y][1] == player && after[x][y] != before[x][y];
+			if (vacated && (move.from[0] == -1 || before[x][y][0] == 'k')) move.from = {x, y}; //castling moves the king and a rook
+			if (arrived && (move.to[0] == -1 || after[x][y][0] == 'k')) move.to = {x, y};
+		}
+	}
+	if (move.from[0] == -1 || move.to[0] == -1) return move;
+	if (after[move.to[0]][move.to[1]][0] != before[move.from[0]][move.from[1]][0])
+		move.promotion = after[move.to[0]][move.to[1]][0];
+	return move;
+}
+
+int pieceIndex(const std::string &piece)
+{
+	int type = 0;
+	switch (piece[0])
+	{
+		case 'p': type = 0; break;
+		case 'n': type = 1; break;
+		case 'b': type = 2; break;
+		case 'r': type = 3; break;
+		case 'q': type = 4; break;
+		case 'k': type = 5; break;
+	}
+	return type + (piece[1] == 'd' ? 6 : 0);
+}
+
+uint64_t splitmix64(uint64_t &seed)
+{
+	seed += 0x9E3779B97F4A7C15ull;
+	uint64_t z = seed;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+uint64_t zobristSeed = 0x9E3779B97F4A7C15ull;
+
+std::array<std::array<uint64_t, 64>, 12> zobristPieces = []()
+{
+	std::array<std::array<uint64_t, 64>, 12> keys;
+	for (auto &piece: keys)
+		for (uint64_t &key: piece)
+			key = splitmix64(zobristSeed);
+	return keys;
+}();
+
+std::array<uint64_t, 15> zobristState = []() //dark to move, 6 castling rights, 8 en passant files
+{
+	std::array<uint64_t, 15> keys;
+	for (uint64_t &key: keys) key = splitmix64(zobristSeed);
+	return keys;
+}();
+
+uint64_t positionKey(Position &position)
+{
+	uint64_t key = 0;
+	for (int x{0}; x<8; x++)
+		for (int y{0}; y<8; y++)
+			if (position[x][y] != "") key ^= zobristPieces[pieceIndex(position[x][y])][x*8+y];
+	if (position.turnPlayer == 'd') key ^= zobristState[0];
+	for (int i{0}; i<3; i++)
+	{
+		if (position.castlingRights['l'][i]) key ^= zobristState[1+i];
+		if (position.castlingRights['d'][i]) key ^= zobristState[4+i];
+	}
+	if (position.enPassantAllowed) key ^= zobristState[7+position.enPassantSquare[1]];
+	return key;
+}
+
+std::vector<Position> legalMoves(Position &position)
+{
+	MoveGenerator moveGenerator = {position, false};
+	std::vector<Position> moves = {};
+	for (Position move = moveGenerator.next(); !moveGenerator.done; move = moveGenerator.next())
+		moves.push_back(move);
+	return moves;
+}
+
+Position randomPosition(std::mt19937_64 &random)
+{
+	std::array<std::string, 12> pieces = {"pl", "nl", "bl", "rl", "ql", "kl", "pd", "nd", "bd", "rd", "qd", "kd"};
+	Position position = {{}, {{'l', {false, false, false}}, {'d', {false, false, false}}}, 'l', false, {0, 0}};
+	for (int x{0}; x<8; x++)
+		for (int y{0}; y<8; y++)
+			if (random()%3 == 0) position[x][y] = pieces[random()%12];
+	return position;
+}
+
+bool insufficientMaterial(Position &position)
+{
+	int minors = 0;
+	for (int x{0}; x<8; x++)
+	{
+		for (int y{0}; y<8; y++)
+		{
+			if (position[x][y] == "" || position[x][y][0] == 'k') continue;
+			if (position[x][y][0] != 'n' && position[x][y][0] != 'b') return false;
+			minors++;
+		}
+	}
+	return minors <= 1;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+struct CastlingRights //indexed by player like a std::map<char, ...>, but copies without allocating
+{
+	std::array<std::array<bool, 3>, 2> players = {};
+	CastlingRights() {}
+	CastlingRights(std::initializer_list<std::pair<char, std::array<bool, 3>>> rights)
+	{
+		for (auto &player: rights) (*this)[player.first] = player.second;
+	}
+	std::array<bool, 3> &operator[](char player)
+	{
+		return players[player == 'd'];
+	}
+	const std::array<bool, 3> &operator[](char player) const
+	{
+		return players[player == 'd'];
+	}
+	bool operator==(const CastlingRights &other) const
+	{
+		return players == other.players;
+	}
+};
+
+struct Position
+{
+	std::array<std::array<std::string, 8>, 8> board;
+	CastlingRights castlingRights; //0 is king, 1 is left rook, 2 is right rook
+	char turnPlayer;
+	bool enPassantAllowed;
+	std::array<int, 2> enPassantSquare;
+	std::array<std::string, 8>& operator[](int x)
+	{
+		return board[x];
+	}
+	const std::array<std::string, 8>& operator[](int x) const
+	{
+		return board[x];
+	}
+	bool operator==(Position other)
+	{
+		return board == other.board
+		&& castlingRights == other.castlingRights
+		&& turnPlayer == other.turnPlayer
+		&& enPassantAllowed == other.enPassantAllowed
+		&& enPassantSquare == other.enPassantSquare;
+	}
+	void toggleTurn()
+	{
+		if (turnPlayer == 'l') turnPlayer = 'd';
+		else if (turnPlayer == 'd') turnPlayer = 'l';
+	}
+};
+
+enum class GenType { all, captures, quiets, evasions };
+
+struct GenMove //a pseudo-legal move, turned into a Position by MoveGenerator::next
+{
+	static const uint8_t promotion = 1;
+	static const uint8_t doublePush = 2;
+	static const uint8_t enPassant = 4;
+	static const uint8_t castleKingside = 8;
+	static const uint8_t castleQueenside = 16;
+	int8_t fromX;
+	int8_t fromY;
+	int8_t toX;
+	int8_t toY;
+	uint8_t flags;
+};
+
+const int maxMoves = 256;
+
+struct MoveGenerator //hands out the positions after each pseudo-legal move, or only the legal ones
+{
+	Position position;
+	bool ignoreCheck;
+	std::array<GenMove, maxMoves> moves;
+	int count;
+	int index;
+	bool done;
+	std::array<int16_t, maxMoves> exchange; //static exchange value of each move, 0 for quiet moves, filled by orderCaptures
+	bool ordered = false;
+	bool lastCapture = false; //about the move next() returned last
+	int lastExchange = 0;
+	MoveGenerator(Position _position, bool _ignoreCheck = true, bool _onlyCaptures = false)
+	: MoveGenerator(_position, _ignoreCheck, _onlyCaptures ? GenType::captures : GenType::all) {}
+	MoveGenerator(Position _position, bool _ignoreCheck, GenType type);
+	void orderCaptures(); //winning and even captures by exchange value, then quiet moves, then losing captures
+	Position next();
+};
+
+struct Move
+{
+	std::array<int, 2> from;
+	std::array<int, 2> to;
+	char promotion; //piece letter, or 0
+	bool operator==(const Move &other) const
+	{
+		return from == other.from && to == other.to && promotion == other.promotion;
+	}
+};
+
+void playMove(Position &position, const GenMove &move); //one of MoveGenerator::moves, so a move can be kept without its position
+void updateNewPosition(Position &newPosition, int x, int y, int i, int j); //moves the piece on x, y by i, j and passes the turn, the part every move shares
+bool isCheck(const Position &position); //whether the player who just moved left their king attacked
+int pieceValue(char piece); //centipawns, for exchanges
+int staticExchange(const Position &position, const Move &move); //centipawns the side to move nets on move.to if both sides keep recapturing with their least valuable piece
+Move moveBetween(Position &before, Position &after);
+int pieceIndex(const std::string &piece);
+uint64_t splitmix64(uint64_t &seed);
+uint64_t positionKey(Position &position);
+std::vector<Position> legalMoves(Position &position);
+Position randomPosition(std::mt19937_64 &random);
+bool insufficientMaterial(Position &position);
+extern std::array<std::array<uint64_t, 64>, 12> zobristPieces;
@@ -0,0 +1,344 @@
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "search.h"
+#include "cache.h"
+#include "evaluate.h"
+#include "mcts.h"
+#include "nnue.h"
+#include "position.h"
+
+thread_local std::mt19937 noiseRandom(std::random_device{}());
+
+float evaluateLeaf(Position &position)
+{
+	float value = nnueActive() ? evaluateNnue(position) : evaluateClassic(position);
+	if (evalSettings.noise > 0.f)
+		value += std::uniform_real_distribution<float>(-evalSettings.noise, evalSettings.noise)(noiseRandom);
+	return value;
+}
+
+thread_local SearchLimits searchLimits;
+
+struct PvTable //triangular: line[ply] is the best line found from the node at ply
+{
+	std::array<std::array<Move, 64>, 64> line;
+	std::array<int, 64> length = {};
+	int ply = 0;
+};
+
+thread_local PvTable pvTable;
+
+void searchPush(Position &parent, Position &child)
+{
+	nnuePush(parent, child);
+	pvTable.ply++;
+}
+
+void searchPop()
+{
+	nnuePop();
+	pvTable.ply--;
+}
+
+void updatePv(Position &position, Position &move)
+{
+	int ply = pvTable.ply;
+	if (ply+1 >= 64) return;
+	pvTable.line[ply][0] = moveBetween(position, move);
+	int length = std::min(pvTable.length[ply+1], 62);
+	std::copy(pvTable.line[ply+1].begin(), pvTable.line[ply+1].begin()+length, pvTable.line[ply].begin()+1);
+	pvTable.length[ply] = length+1;
+}
+
+TranspositionTable *transpositionTable = nullptr; //searches without one unless a caller installs it
+
+float quiesce(Position &position, float alpha, float beta) //captures until the position is quiet, losing ones never searched
+{
+	if (pvTable.ply < 64) pvTable.length[pvTable.ply] = 0;
+	if (searchLimits.aborted) return 0.f;
+	if ((++searchLimits.nodes & 1023) == 0 && searchLimits.exceeded())
+	{
+		searchLimits.aborted = true;
+		return 0.f;
+	}
+	float value = evaluateLeaf(position); //standing pat, the side to move need not capture
+	bool light = position.turnPlayer == 'l';
+	if (pvTable.ply >= 63 || (light ? value >= beta : value <= alpha)) return value;
+	if (light) alpha = std::max(alpha, value);
+	else beta = std::min(beta, value);
+	MoveGenerator moveGenerator = {position, false, true};
+	moveGenerator.orderCaptures();
+	for (Position move = moveGenerator.next(); !moveGenerator.done; move = moveGenerator.next())
+	{
+		if (moveGenerator.lastExchange < 0) break; //ordered last, so the rest lose material too
+		searchPush(position, move);
+		float result = quiesce(move, alpha, beta);
+		searchPop();
+		if (light ? result > value : result < value)
+		{
+			value = result;
+			updatePv(position, move);
+		}
+		if (light) alpha = std::max(alpha, value);
+		else beta = std::min(beta, value);
+		if (beta <= alpha) break;
+	}
+	return value;
+}
+
+int reduction(MoveGenerator &moveGenerator, int depth) //a ply less for captures that lose material by exchange
+{
+	return depth >= 2 && moveGenerator.lastCapture && moveGenerator.lastExchange < 0 ? 1 : 0;
+}
+
+float evaluate(Position &position, int depth, float alpha, float beta, float contempt)
+{
+	if (pvTable.ply < 64) pvTable.length[pvTable.ply] = 0;
+	if (searchLimits.aborted) return 0.f;
+	if ((++searchLimits.nodes & 1023) == 0 && searchLimits.exceeded())
+	{
+		searchLimits.aborted = true;
+		return 0.f;
+	}
+	if (depth > 0) {
+		uint64_t key = 0;
+		float alphaOriginal = alpha;
+		float betaOriginal = beta;
+		if (transpositionTable)
+		{
+			float stored;
+			key = positionKey(position);
+			if (transpositionTable->probe(key, depth, alpha, beta, stored)) return stored;
+		}
+		MoveGenerator moveGenerator = {position, false};
+		moveGenerator.orderCaptures();
+		Position move = moveGenerator.next();
+		if (moveGenerator.done) 
+		{
+			position.toggleTurn();
+			if (!isCheck(position))
+			{
+				position.toggleTurn();
+				return contempt;
+			}
+			position.toggleTurn();
+		}
+		float value = 0.f;
+		if (position.turnPlayer == 'l')
+		{
+			value = -5000.f - static_cast<float>(depth); //less moves, more good
+			while (!moveGenerator.done)
+			{
+				searchPush(position, move);
+				int reduced = reduction(moveGenerator, depth);
+				float result = evaluate(move, depth-1-reduced, alpha, beta, contempt);
+				if (reduced > 0 && result > alpha) result = evaluate(move, depth-1, alpha, beta, contempt); //the capture was better than it looked
+				searchPop();
+				if (result > value)
+				{
+					value = result;
+					updatePv(position, move);
+				}
+				alpha = std::max(alpha, value);
+				if (beta <= alpha) break;
+				move = moveGenerator.next();
+			}
+		}
+		if (position.turnPlayer == 'd')
+		{
+			value = 5000.f + static_cast<float>(depth);
+			while (!moveGenerator.done)
+			{
+				searchPush(position, move);
+				int reduced = reduction(moveGenerator, depth);
+				float result = evaluate(move, depth-1-reduced, alpha, beta, contempt);
+				if (reduced > 0 && result < beta) result = evaluate(move, depth-1, alpha, beta, contempt); //the capture was better than it looked
+				searchPop();
+				if (result < value)
+				{
+					value = result;
+					updatePv(position, move);
+				}
+				beta = std::min(beta, value);
+				if (beta <= alpha) break;
+				move = moveGenerator.next();
+			}
+		}
+		if (transpositionTable && !searchLimits.aborted)
+		{
+			TranspositionTable::Bound bound = TranspositionTable::exact;
+			if (value <= alphaOriginal) bound = TranspositionTable::upper;
+			else if (value >= betaOriginal) bound = TranspositionTable::lower;
+			transpositionTable->store(key, depth, value, bound);
+		}
+		return value;
+	}
+	return quiesce(position, alpha, beta);
+}
+
+thread_local SearchArena searchArena;
+
+void beginSearch()
+{
+	searchArena.reset();
+	pvTable.ply = 0;
+}
+
+RootMoves rankRootMoves(Position &position, int depth, int multipv)
+{
+	MoveGenerator moveGenerator = {position, false};
+	RootMoves moves = {};
+	moves.reserve(256);
+	std::vector<float, ArenaAllocator<float>> best = {}; //exact values, best first
+	best.reserve(256);
+	bool light = position.turnPlayer == 'l'; //l player wants highest value, d player wants lowest value
+	auto better = [light](float a, float b) { return light ? a > b : a < b; };
+	nnueRoot(position);
+	pvTable.ply = 0;
+	for (Position move = moveGenerator.next(); !moveGenerator.done; move = moveGenerator.next())
+	{
+		moves.push_back({move, 0.f, true, {}});
+		RankedMove &ranked = moves.back();
+		searchPush(position, ranked.position);
+		if (multipv > 0 && static_cast<int>(best.size()) >= multipv)
+		{
+			float kth = best[multipv-1]; //only moves beating this are searched with a full window
+			float alpha = light ? kth : std::nextafter(kth, -1e9f);
+			float beta = light ? std::nextafter(kth, 1e9f) : kth;
+			ranked.value = evaluate(ranked.position, depth-1, alpha, beta, 1.f);
+			ranked.exact = better(ranked.value, kth);
+		}
+		if (ranked.exact)
+		{
+			ranked.value = evaluate(ranked.position, depth-1, -5000.f, 5000.f, 1.f);
+			best.insert(std::upper_bound(best.begin(), best.end(), ranked.value, better), ranked.value);
+		}
+		searchPop();
+		if (searchLimits.aborted) break;
+		if (!ranked.exact) continue;
+		ranked.pv.push_back(moveBetween(position, ranked.position));
+		ranked.pv.insert(ranked.pv.end(), pvTable.line[1].begin(), pvTable.line[1].begin()+pvTable.length[1]);
+	}
+	nnueDone();
+	std::vector<int, ArenaAllocator<int>> order(moves.size()); //std::stable_sort would allocate its buffer on the heap
+	for (std::size_t i{0}; i<order.size(); i++) order[i] = static_cast<int>(i);
+	std::sort(order.begin(), order.end(), [&moves, &better](int a, int b)
+	{
+		if (moves[a].exact != moves[b].exact) return moves[a].exact;
+		if (moves[a].exact && better(moves[a].value, moves[b].value)) return true;
+		if (moves[a].exact && better(moves[b].value, moves[a].value)) return false;
+		return a < b;
+	});
+	RootMoves sorted = {};
+	sorted.reserve(moves.size());
+	for (int i: order) sorted.push_back(std::move(moves[i]));
+	return sorted;
+}
+
+RootMoves iterativeDeepening(Position &position, int maxDepth, int multipv, long long nodeBudget, long long moveTime,
+	const std::function<void(int, RootMoves&)> &completed)
+{
+	auto start = std::chrono::steady_clock::now();
+	searchLimits = {};
+	beginSearch();
+	RootMoves moves = {};
+	for (int depth{1}; depth<=maxDepth; depth++)
+	{
+		if (depth == 2) //depth 1 always completes, so there is a move to play
+		{
+			searchLimits.nodeBudget = nodeBudget;
+			searchLimits.deadline = start + std::chrono::milliseconds(moveTime);
+			searchLimits.timed = moveTime > 0;
+		}
+		RootMoves deeper = rankRootMoves(position, depth, multipv);
+		if (searchLimits.aborted || deeper.empty()) break;
+		moves = std::move(deeper);
+		if (completed) completed(depth, moves);
+		auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+		if (moveTime > 0 && elapsed * 4 > moveTime) break; //the next depth would not finish in time
+	}
+	searchLimits = {};
+	return moves;
+}
+
+bool cachedMove(Position &position, int depth, Position &move) //a cached result at least depth deep that is still legal here
+{
+	CachedResult cached;
+	if (!analysisCache || !analysisCache->probe(cacheKey(position), cached) || cached.depth < depth) return false;
+	MoveGenerator moveGenerator = {position, false};
+	for (Position child = moveGenerator.next(); !moveGenerator.done; child = moveGenerator.next())
+	{
+		if (!(moveBetween(position, child) == cached.move)) continue;
+		move = child;
+		return true;
+	}
+	return false;
+}
+
+void cacheMove(Position &position, int depth, RankedMove &best)
+{
+	if (analysisCache && best.exact && !best.pv.empty()) analysisCache->store(cacheKey(position), {depth, best.value, best.pv[0]});
+}
+
+Position generateBotMove(Position &position, int depth, int moveTime)
+{
+	if (mctsSettings.enabled)
+	{
+		MctsReport report;
+		return mctsSearch(position, mctsSettings.playouts, mctsSettings.moveTime, report);
+	}
+	beginSearch();
+	Position cached;
+	if (cachedMove(position, depth, cached)) return cached;
+	int completed = depth;
+	RootMoves moves = moveTime > 0 ? iterativeDeepening(position, depth, 1, 0, moveTime, [&completed](int reached, RootMoves&) { completed = reached; })
+		: rankRootMoves(position, depth, 1);
+	if (moves.empty()) return position; //no legal moves
+	cacheMove(position, completed, moves[0]);
+	return moves[0].position;
+}
+
+std::array<DifficultyProfile, 5> difficultyProfiles = {{
+	{"3 year old", 2, 2000, 100, 1.5f, 0.5f, 5},
+	{"Idiot", 3, 10000, 250, 0.75f, 0.3f, 4},
+	{"Easy", 4, 50000, 500, 0.3f, 0.15f, 3},
+	{"Hard", 5, 200000, 1000, 0.1f, 0.05f, 2},
+	{"Challenging", 8, 1000000, 3000, 0.f, 0.f, 1},
+}};
+
+Position generateBotMove(Position &position, const DifficultyProfile &profile, std::mt19937_64 &random)
+{
+	if (mctsSettings.enabled) //the profile's time budget and noise, MCTS has no depth or candidates
+	{
+		EvalSettings settings = evalSettings;
+		evalSettings.noise = profile.noise;
+		MctsReport report;
+		Position move = mctsSearch(position, mctsSettings.playouts, profile.timeBudget, report);
+		evalSettings = settings;
+		return move;
+	}
+	bool cacheable = profile.noise == 0.f && profile.blunderChance == 0.f; //noisy levels are meant to vary between games
+	Position cached;
+	if (cacheable && cachedMove(position, profile.maxDepth, cached)) return cached;
+	EvalSettings settings = evalSettings;
+	evalSettings.noise = profile.noise;
+	int completed = 0;
+	RootMoves moves = iterativeDeepening(position, profile.maxDepth, profile.candidates, profile.nodeBudget, profile.timeBudget,
+		[&completed](int depth, RootMoves&) { completed = depth; });
+	evalSettings = settings;
+	if (moves.empty()) return position; //no legal moves
+	if (cacheable)
+	{
+		if (cachedMove(position, completed+1, cached)) return cached; //an earlier run got deeper than this one
+		cacheMove(position, completed, moves[0]);
+	}
+
+	int exact = 0;
+	while (exact < profile.candidates && exact < static_cast<int>(moves.size()) && moves[exact].exact) exact++;
+	if (exact > 1 && std::uniform_real_distribution<float>(0.f, 1.f)(random) < profile.blunderChance)
+		return moves[1 + random()%(exact-1)].position;
+	return moves[0].position;
+}
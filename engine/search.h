@@ -0,0 +1,148 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "position.h"
+
+float evaluateLeaf(Position &position);
+
+struct SearchLimits
+{
+	long long nodes = 0;
+	long long nodeBudget = 0; //0 is unlimited
+	std::chrono::steady_clock::time_point deadline;
+	bool timed = false;
+	bool aborted = false;
+	bool exceeded()
+	{
+		if (nodeBudget > 0 && nodes >= nodeBudget) return true;
+		return timed && std::chrono::steady_clock::now() >= deadline;
+	}
+};
+
+extern thread_local SearchLimits searchLimits;
+
+struct TranspositionTable //shared between search threads, lockless like PerftHash
+{
+	enum Bound { exact, lower, upper };
+	struct Entry
+	{
+		std::atomic<uint64_t> check{0};
+		std::atomic<uint64_t> data{0}; //value bits << 32 | depth << 8 | bound
+	};
+	std::vector<Entry> entries;
+	TranspositionTable(std::size_t megabytes)
+	{
+		std::size_t size = 1;
+		while (size * 2 * sizeof(Entry) <= megabytes << 20) size *= 2;
+		entries = std::vector<Entry>(size);
+	}
+	bool probe(uint64_t key, int depth, float alpha, float beta, float &value)
+	{
+		Entry &entry = entries[key & (entries.size()-1)];
+		uint64_t data = entry.data.load(std::memory_order_relaxed);
+		if ((entry.check.load(std::memory_order_relaxed) ^ data) != key) return false;
+		if (static_cast<int>(data >> 8 & 0xFF) < depth) return false;
+		uint32_t bits = static_cast<uint32_t>(data >> 32);
+		std::memcpy(&value, &bits, sizeof(float));
+		Bound bound = static_cast<Bound>(data & 0xFF);
+		return bound == exact || (bound == lower && value >= beta) || (bound == upper && value <= alpha);
+	}
+	void store(uint64_t key, int depth, float value, Bound bound)
+	{
+		Entry &entry = entries[key & (entries.size()-1)];
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(float));
+		uint64_t data = static_cast<uint64_t>(bits) << 32 | static_cast<uint64_t>(depth) << 8 | bound;
+		entry.check.store(key ^ data, std::memory_order_relaxed);
+		entry.data.store(data, std::memory_order_relaxed);
+	}
+};
+
+extern TranspositionTable *transpositionTable;
+float evaluate(Position &position, int depth, float alpha, float beta, float contempt); //resolves captures past depth 0
+
+struct SearchArena //per-thread bump allocator for search-time state, reset when a new search starts
+{
+	static const std::size_t blockSize = 1 << 22;
+	std::vector<std::unique_ptr<unsigned char[]>> blocks;
+	std::size_t block = 0;
+	std::size_t used = 0;
+	void *allocate(std::size_t bytes, std::size_t alignment)
+	{
+		used = (used + alignment-1) & ~(alignment-1);
+		if (block >= blocks.size() || used + bytes > blockSize)
+		{
+			if (bytes > blockSize) throw std::bad_alloc();
+			if (block < blocks.size()) block++;
+			used = 0;
+			if (block == blocks.size()) blocks.emplace_back(new unsigned char[blockSize]); //only until the arena has grown to fit a search
+		}
+		void *memory = blocks[block].get() + used;
+		used += bytes;
+		return memory;
+	}
+	void reset()
+	{
+		block = 0;
+		used = 0;
+	}
+};
+
+extern thread_local SearchArena searchArena;
+
+template <typename T>
+struct ArenaAllocator //containers using it must not outlive the next search on their thread
+{
+	using value_type = T;
+	ArenaAllocator() {}
+	template <typename U> ArenaAllocator(const ArenaAllocator<U>&) {}
+	T *allocate(std::size_t count)
+	{
+		return static_cast<T*>(searchArena.allocate(count * sizeof(T), alignof(T)));
+	}
+	void deallocate(T*, std::size_t) {}
+	template <typename U> bool operator==(const ArenaAllocator<U>&) const { return true; }
+	template <typename U> bool operator!=(const ArenaAllocator<U>&) const { return false; }
+};
+
+void beginSearch();
+
+struct RankedMove
+{
+	Position position;
+	float value;
+	bool exact; //otherwise value is only a bound showing the move is not in the top multipv
+	std::vector<Move, ArenaAllocator<Move>> pv;
+};
+
+using RootMoves = std::vector<RankedMove, ArenaAllocator<RankedMove>>;
+RootMoves rankRootMoves(Position &position, int depth, int multipv = 0); //best first for the player to move, 0 ranks every move exactly
+//the moves of the deepest completed depth; depth 1 always completes, later depths stop at the node budget or after moveTime milliseconds
+RootMoves iterativeDeepening(Position &position, int maxDepth, int multipv, long long nodeBudget, long long moveTime,
+	const std::function<void(int, RootMoves&)> &completed = nullptr);
+Position generateBotMove(Position &position, int depth, int moveTime = 0);
+
+struct DifficultyProfile
+{
+	std::string name;
+	int maxDepth;
+	long long nodeBudget;
+	int timeBudget; //milliseconds
+	float noise; //pawns
+	float blunderChance; //of playing one of the other candidates
+	int candidates; //ranked root moves the blunder is picked from
+};
+
+extern std::array<DifficultyProfile, 5> difficultyProfiles;
+Position generateBotMove(Position &position, const DifficultyProfile &profile, std::mt19937_64 &random);
@@ -0,0 +1,24 @@
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "alloc_count.h"
+
+thread_local long long heapAllocations = 0;
+
+__attribute__((noinline)) void *operator new(std::size_t size)
+{
+	heapAllocations++;
+	if (void *memory = std::malloc(size ? size : 1)) return memory;
+	throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void *memory) noexcept
+{
+	std::free(memory);
+}
+
+__attribute__((noinline)) void operator delete(void *memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+extern thread_local long long heapAllocations; //counted by the global operator new that alloc_count.cpp replaces, in chess-bench only
@@ -0,0 +1,368 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../engine/nnue.h"
+#include "../engine/notation.h"
+#include "../engine/pgn.h"
+#include "../engine/position.h"
+#include "../engine/search.h"
+
+int analysePgn(int argc, char *argv[])
+{
+	if (argc < 3)
+	{
+		std::cout << "usage: chess-analyse pgn <file> [--threads n] [--depth d] [--queue n]" << std::endl;
+		return 1;
+	}
+	int threads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+	int depth = 0; //0 only validates the games
+	int queueDepth = 64;
+	for (int arg{3}; arg+1<argc; arg+=2)
+	{
+		std::string option = argv[arg];
+		if (option == "--threads") threads = std::max(std::stoi(argv[arg+1]), 1);
+		else if (option == "--depth") depth = std::stoi(argv[arg+1]);
+		else if (option == "--queue") queueDepth = std::max(std::stoi(argv[arg+1]), 1);
+	}
+	PgnReader reader(argv[2]);
+	if (!reader.open())
+	{
+		std::cout << "could not open " << argv[2] << std::endl;
+		return 1;
+	}
+
+	std::vector<PgnGame> slots(queueDepth);
+	std::vector<int> freeSlots = {};
+	std::deque<int> readySlots = {};
+	for (int slot{0}; slot<queueDepth; slot++) freeSlots.push_back(slot);
+	std::mutex queueMutex;
+	std::condition_variable slotFreed;
+	std::condition_variable slotReady;
+	bool finished = false;
+	std::atomic<long long> games{0}, moves{0}, invalid{0}, agreed{0};
+	std::mutex outputMutex;
+
+	auto worker = [&]()
+	{
+		while (true)
+		{
+			int slot;
+			{
+				std::unique_lock<std::mutex> lock(queueMutex);
+				slotReady.wait(lock, [&]() { return !readySlots.empty() || finished; });
+				if (readySlots.empty()) return;
+				slot = readySlots.front();
+				readySlots.pop_front();
+			}
+			PgnGame &game = slots[slot];
+			Position position;
+			std::string fen = game.tag("FEN");
+			if (fen == "" || !positionFromFen(fen, position)) positionFromFen(startFen, position);
+			Position next;
+			for (int ply{0}; ply<game.moveCount; ply++)
+			{
+				if (!sanToPosition(position, game.moves[ply], next))
+				{
+					invalid++;
+					std::lock_guard<std::mutex> lock(outputMutex);
+					std::cout << "illegal move " << game.moves[ply] << " at ply " << ply+1 << " in \""
+					<< game.tag("White") << " - " << game.tag("Black") << "\" from " << fenFromPosition(position) << std::endl;
+					break;
+				}
+				if (depth > 0 && generateBotMove(position, depth) == next) agreed++;
+				position = next;
+				moves++;
+			}
+			games++;
+			std::lock_guard<std::mutex> lock(queueMutex);
+			freeSlots.push_back(slot);
+			slotFreed.notify_one();
+		}
+	};
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> pool = {};
+	for (int thread{0}; thread<threads; thread++) pool.emplace_back(worker);
+	while (true)
+	{
+		int slot;
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			slotFreed.wait(lock, [&]() { return !freeSlots.empty(); }); //back-pressure on the reader
+			slot = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		bool read = reader.next(slots[slot]);
+		std::lock_guard<std::mutex> lock(queueMutex);
+		if (!read)
+		{
+			finished = true;
+			slotReady.notify_all();
+			break;
+		}
+		readySlots.push_back(slot);
+		slotReady.notify_one();
+	}
+	for (std::thread &thread: pool) thread.join();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << games << " games, " << moves << " moves, " << invalid << " with illegal moves in " << seconds << "s ("
+	<< static_cast<long long>(games / std::max(seconds, 1e-9)) << " games/sec)" << std::endl;
+	if (depth > 0)
+		std::cout << "engine at depth " << depth << " agreed with " << 100.0 * agreed / std::max(moves.load(), 1ll) << "% of moves" << std::endl;
+	return 0;
+}
+
+bool jsonValue(const std::string &line, const std::string &key, std::string &value) //raw JSON text of a top-level field
+{
+	std::string quoted = "\"" + key + "\"";
+	std::size_t at = line.find(quoted);
+	if (at == std::string::npos) return false;
+	at = line.find_first_not_of(" \t", at + quoted.size());
+	if (at == std::string::npos || line[at] != ':') return false;
+	at = line.find_first_not_of(" \t", at+1);
+	if (at == std::string::npos) return false;
+	std::size_t end = at;
+	if (line[at] == '"')
+	{
+		for (end = at+1; end < line.size() && line[end] != '"'; end++)
+			if (line[end] == '\\') end++;
+		end++;
+	}
+	else while (end < line.size() && line[end] != ',' && line[end] != '}' && !std::isspace(static_cast<unsigned char>(line[end]))) end++;
+	if (end > line.size()) return false;
+	value = line.substr(at, end-at);
+	return true;
+}
+
+std::string jsonUnquote(const std::string &value)
+{
+	if (value.size() < 2 || value[0] != '"') return value;
+	std::string text = "";
+	for (std::size_t i{1}; i+1<value.size(); i++)
+	{
+		if (value[i] == '\\' && i+2 < value.size()) i++;
+		text += value[i];
+	}
+	return text;
+}
+
+std::string jsonString(const std::string &text)
+{
+	std::string quoted = "\"";
+	for (char c: text)
+	{
+		if (c == '"' || c == '\\') quoted += '\\';
+		quoted += c;
+	}
+	return quoted + "\"";
+}
+
+RootMoves analyse(Position &position, int depth, int moveTime, int multipv)
+{
+	if (moveTime > 0) return iterativeDeepening(position, depth, multipv, 0, moveTime);
+	beginSearch();
+	return rankRootMoves(position, depth, multipv);
+}
+
+struct AnalysisConnection
+{
+	std::FILE *out;
+	std::mutex mutex;
+	std::condition_variable finished;
+	int running = 0;
+};
+
+struct AnalysisJob
+{
+	std::string line;
+	AnalysisConnection *connection;
+};
+
+std::string runAnalysisJob(const std::string &line)
+{
+	std::string id = "null";
+	std::string fen = "";
+	std::string field = "";
+	int depth = 3;
+	int moveTime = 0;
+	int multipv = 1;
+	jsonValue(line, "id", id);
+	try
+	{
+		if (jsonValue(line, "fen", field)) fen = jsonUnquote(field);
+		if (jsonValue(line, "depth", field)) depth = std::max(std::stoi(field), 1);
+		if (jsonValue(line, "movetime", field)) moveTime = std::stoi(field);
+		if (jsonValue(line, "multipv", field)) multipv = std::max(std::stoi(field), 1);
+	}
+	catch (const std::exception &)
+	{
+		return "{\"id\":" + id + ",\"error\":\"invalid job\"}";
+	}
+	Position position;
+	if (fen == "" || !positionFromFen(fen, position)) return "{\"id\":" + id + ",\"error\":\"invalid fen\"}";
+	if (moveTime > 0 && !jsonValue(line, "depth", field)) depth = 64;
+
+	auto start = std::chrono::steady_clock::now();
+	RootMoves moves = analyse(position, depth, moveTime, multipv);
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+	std::string result = "{\"id\":" + id + ",\"fen\":" + jsonString(fen) + ",\"time_ms\":" + std::to_string(elapsed) + ",\"lines\":[";
+	for (int rank{0}; rank<multipv && rank<static_cast<int>(moves.size()) && moves[rank].exact; rank++)
+	{
+		std::ostringstream score;
+		score << moves[rank].value;
+		std::string pv = "";
+		for (Move &move: moves[rank].pv) pv += std::string(pv == "" ? "" : " ") + moveToUci(move);
+		result += std::string(rank ? "," : "") + "{\"rank\":" + std::to_string(rank+1)
+		+ ",\"move\":\"" + moveToUci(moveBetween(position, moves[rank].position))
+		+ "\",\"san\":" + jsonString(moveToSan(position, moves[rank].position)) + ",\"score\":" + score.str()
+		+ ",\"pv\":\"" + pv + "\"}";
+	}
+	return result + "]}";
+}
+
+struct AnalysisService
+{
+	std::deque<AnalysisJob> queue;
+	std::size_t queueDepth;
+	std::mutex mutex;
+	std::condition_variable jobAdded;
+	std::condition_variable jobTaken;
+	bool stopping = false;
+	std::vector<std::thread> searchers;
+	AnalysisService(int threads, std::size_t _queueDepth)
+	{
+		queueDepth = _queueDepth;
+		for (int thread{0}; thread<threads; thread++) searchers.emplace_back([this]() { work(); });
+	}
+	~AnalysisService()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		jobAdded.notify_all();
+		for (std::thread &thread: searchers) thread.join();
+	}
+	void work()
+	{
+		while (true)
+		{
+			AnalysisJob job;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				jobAdded.wait(lock, [this]() { return !queue.empty() || stopping; });
+				if (queue.empty()) return;
+				job = std::move(queue.front());
+				queue.pop_front();
+			}
+			jobTaken.notify_one();
+			std::string result = runAnalysisJob(job.line);
+			std::lock_guard<std::mutex> lock(job.connection->mutex);
+			std::fputs((result + "\n").c_str(), job.connection->out);
+			std::fflush(job.connection->out);
+			job.connection->running--;
+			job.connection->finished.notify_all();
+		}
+	}
+	void serve(std::FILE *in, std::FILE *out) //returns once every job read from in has been answered
+	{
+		AnalysisConnection connection;
+		connection.out = out;
+		char *buffer = nullptr;
+		std::size_t capacity = 0;
+		while (getline(&buffer, &capacity, in) != -1)
+		{
+			std::string line = buffer;
+			if (line.find_first_not_of(" \t\r\n") == std::string::npos) continue;
+			{
+				std::lock_guard<std::mutex> lock(connection.mutex);
+				connection.running++;
+			}
+			std::unique_lock<std::mutex> lock(mutex);
+			jobTaken.wait(lock, [this]() { return queue.size() < queueDepth; }); //back-pressure: stop reading while the queue is full
+			queue.push_back({line, &connection});
+			lock.unlock();
+			jobAdded.notify_one();
+		}
+		std::free(buffer);
+		std::unique_lock<std::mutex> lock(connection.mutex);
+		connection.finished.wait(lock, [&connection]() { return connection.running == 0; });
+	}
+};
+
+int analysisService(int argc, char *argv[])
+{
+	int threads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+	int queueDepth = 64;
+	int hashSize = 64;
+	std::string socketPath = "";
+	for (int arg{2}; arg+1<argc; arg+=2)
+	{
+		std::string option = argv[arg];
+		if (option == "--threads") threads = std::max(std::stoi(argv[arg+1]), 1);
+		else if (option == "--queue") queueDepth = std::max(std::stoi(argv[arg+1]), 1);
+		else if (option == "--hash") hashSize = std::max(std::stoi(argv[arg+1]), 1);
+		else if (option == "--socket") socketPath = argv[arg+1];
+		else if (option == "--nnue") loadNetwork(argv[arg+1]);
+	}
+	TranspositionTable table(hashSize);
+	transpositionTable = &table;
+	{
+		AnalysisService service(threads, queueDepth);
+		if (socketPath == "") service.serve(stdin, stdout);
+		else
+		{
+			int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+			sockaddr_un address = {};
+			address.sun_family = AF_UNIX;
+			std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path)-1);
+			unlink(socketPath.c_str());
+			if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 8) != 0)
+			{
+				std::cout << "could not listen on " << socketPath << std::endl;
+				transpositionTable = nullptr;
+				return 1;
+			}
+			while (true)
+			{
+				int client = accept(listener, nullptr, nullptr);
+				if (client < 0) continue;
+				std::FILE *in = fdopen(dup(client), "r");
+				std::FILE *out = fdopen(client, "w");
+				if (in && out) service.serve(in, out);
+				if (in) std::fclose(in);
+				if (out) std::fclose(out);
+			}
+		}
+	}
+	transpositionTable = nullptr;
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc > 1 && std::string(argv[1]) == "pgn")
+	{
+		return analysePgn(argc, argv);
+	}
+	if (argc > 1 && std::string(argv[1]) == "serve")
+	{
+		return analysisService(argc, argv);
+	}
+	std::cout << "usage: chess-analyse pgn <file> [options] | chess-analyse serve [options]" << std::endl;
+	return 1;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+struct AtlasSprite //a PNG compiled into the binary by pack-sprites, and where it goes in the atlas
+{
+	const char *name; //file name without .png, as the GUI looks sprites up
+	const unsigned char *data;
+	std::size_t size;
+	int x;
+	int y;
+	int width;
+	int height;
+};
+
+extern const int atlasWidth;
+extern const int atlasHeight;
+extern const AtlasSprite atlasSprites[];
+extern const std::size_t atlasSpriteCount;
@@ -0,0 +1,456 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "alloc_count.h"
+
+#include "../engine/evaluate.h"
+#include "../engine/mcts.h"
+#include "../engine/nnue.h"
+#include "../engine/notation.h"
+#include "../engine/position.h"
+#include "../engine/search.h"
+
+const std::vector<std::string> &benchFens() //the bench signature positions, shared by every mode; a function so startFen is set first
+{
+	static const std::vector<std::string> fens = {startFen,
+		"r1bqk2r/2p1bppp/p1np1n2/1p2p3/4P3/1BP2N2/PP1P1PPP/RNBQR1K1 b kq - 0 1",
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+		"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+		"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+		"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+		"4k3/8/8/8/8/8/4P3/4K3 w - - 0 1"};
+	return fens;
+}
+
+int benchEval(int count)
+{
+	std::mt19937_64 random(20241019);
+	std::vector<Position> positions = {};
+	for (int n{0}; n<count; n++) positions.push_back(randomPosition(random));
+
+	auto kernels = availableMaterialKernels();
+	auto defaultKernel = materialKernel;
+	std::vector<float> reference = {};
+	for (MaterialKernel &kernel: kernels)
+	{
+		materialKernel = kernel.function;
+		for (int n{0}; n<count; n++)
+		{
+			float value = evaluateClassic(positions[n]);
+			if (reference.size() < positions.size())
+			{
+				reference.push_back(value);
+				continue;
+			}
+			if (std::memcmp(&value, &reference[n], sizeof(float)) != 0)
+			{
+				std::cout << kernel.name << " differs from scalar on position " << n
+				<< ": " << value << " != " << reference[n] << std::endl;
+				return 1;
+			}
+		}
+		std::cout << kernel.name << ": " << count << " random positions match scalar" << std::endl;
+	}
+
+	int rounds = 20;
+	for (MaterialKernel &kernel: kernels)
+	{
+		materialKernel = kernel.function;
+		float checksum = 0.f;
+		auto start = std::chrono::steady_clock::now();
+		for (int round{0}; round<rounds; round++)
+			for (Position &position: positions)
+				checksum += evaluateClassic(position);
+		auto stop = std::chrono::steady_clock::now();
+		double seconds = std::chrono::duration<double>(stop - start).count();
+		std::cout << kernel.name << ": " << static_cast<long long>(rounds * count / seconds)
+		<< " evals/sec (checksum " << checksum << ")" << std::endl;
+	}
+
+	std::vector<std::array<int8_t, 64>> codes = {};
+	for (Position &position: positions)
+	{
+		std::array<int8_t, 64> code;
+		for (int square{0}; square<64; square++)
+			code[square] = position[square/8][square%8] == "" ? 12 : static_cast<int8_t>(pieceIndex(position[square/8][square%8]));
+		codes.push_back(code);
+	}
+	for (MaterialKernel &kernel: kernels)
+	{
+		long long checksum = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int round{0}; round<rounds*10; round++)
+			for (auto &code: codes)
+				checksum += kernel.function(code);
+		auto stop = std::chrono::steady_clock::now();
+		double seconds = std::chrono::duration<double>(stop - start).count();
+		std::cout << kernel.name << " kernel only: " << static_cast<long long>(rounds * 10 * count / seconds)
+		<< " evals/sec (checksum " << checksum << ")" << std::endl;
+	}
+	materialKernel = defaultKernel;
+	return 0;
+}
+
+int benchNnue(const std::string &path, int count)
+{
+	std::mt19937_64 random(20241019);
+	if (path != "")
+	{
+		if (!loadNetwork(path))
+		{
+			std::cout << "could not load network " << path << std::endl;
+			return 1;
+		}
+	}
+	else
+	{
+		std::cout << "no weights file given, using a random network" << std::endl;
+		randomNetwork(random);
+	}
+
+	std::vector<std::array<Position, 2>> moves = {}; //parent and child pairs from random games
+	while (static_cast<int>(moves.size()) < count)
+	{
+		Position position = randomPosition(random);
+		position[0][4] = "kd";
+		position[7][4] = "kl";
+		for (int ply{0}; ply<40 && static_cast<int>(moves.size()) < count; ply++)
+		{
+			MoveGenerator moveGenerator = {position, true};
+			std::vector<Position> children = {};
+			for (Position child = moveGenerator.next(); !moveGenerator.done; child = moveGenerator.next())
+				children.push_back(child);
+			if (children.empty()) break;
+			Position child = children[random()%children.size()];
+			moves.push_back({position, child});
+			position = child;
+		}
+	}
+
+	Accumulator refreshed;
+	Accumulator updated;
+	for (auto &move: moves)
+	{
+		refreshAccumulator(updated, move[0]);
+		updateAccumulator(updated, move[0], move[1]);
+		refreshAccumulator(refreshed, move[1]);
+		if (updated.values != refreshed.values || outputScalar(updated) != nnueKernels.output(refreshed))
+		{
+			std::cout << "incremental accumulator differs from a full refresh" << std::endl;
+			return 1;
+		}
+	}
+
+	int rounds = 20;
+	float checksum = 0.f;
+	auto start = std::chrono::steady_clock::now();
+	for (int round{0}; round<rounds; round++)
+	{
+		for (auto &move: moves)
+		{
+			refreshAccumulator(refreshed, move[1]);
+			checksum += static_cast<float>(nnueKernels.output(refreshed));
+		}
+	}
+	double refreshSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	for (int round{0}; round<rounds; round++)
+	{
+		for (auto &move: moves)
+		{
+			updated = refreshed;
+			updateAccumulator(updated, move[0], move[1]);
+			checksum += static_cast<float>(updated.values[0]);
+		}
+	}
+	double updateSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	for (int round{0}; round<rounds; round++)
+		for (std::size_t n{0}; n<moves.size(); n++)
+			checksum += static_cast<float>(nnueKernels.output(n%2 ? updated : refreshed));
+	double outputSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	double evaluations = static_cast<double>(rounds) * moves.size();
+	std::cout << "full refresh: " << static_cast<long long>(evaluations / refreshSeconds) << " evals/sec" << std::endl;
+	std::cout << "incremental: " << static_cast<long long>(evaluations / (updateSeconds + outputSeconds)) << " evals/sec" << std::endl;
+	std::cout << "accumulator update: " << updateSeconds / evaluations * 1e9 << " ns" << std::endl;
+	std::cout << "output layer: " << outputSeconds / evaluations * 1e9 << " ns (checksum " << checksum << ")" << std::endl;
+	return 0;
+}
+
+int allocationCheck(int depth)
+{
+	long long totalNodes = 0;
+	long long totalAllocations = 0;
+	for (const std::string &fen: benchFens())
+	{
+		Position position;
+		positionFromFen(fen, position);
+		generateBotMove(position, depth); //warm up the arena and the per-thread tables
+		searchLimits = {};
+		long long before = heapAllocations;
+		generateBotMove(position, depth);
+		long long allocations = heapAllocations - before;
+		std::cout << fen << ": " << searchLimits.nodes << " nodes, " << allocations << " heap allocations" << std::endl;
+		totalNodes += searchLimits.nodes;
+		totalAllocations += allocations;
+	}
+	std::cout << static_cast<double>(totalAllocations) / std::max(totalNodes, 1ll) << " heap allocations per node" << std::endl;
+	return totalAllocations == 0 ? 0 : 1;
+}
+
+int exchangeCheck() //known exchanges, the last five only come out right with x-rays and en passant
+{
+	struct Exchange
+	{
+		std::string fen;
+		std::string move;
+		int value;
+	};
+	std::vector<Exchange> exchanges = {
+		{"1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1", "e1e5", 100},
+		{"4k3/8/3p4/4p3/8/8/8/4QK2 w - - 0 1", "e1e5", -800},
+		{"1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1", "d3e5", -200},
+		{"4r1k1/8/8/4n3/8/8/4R3/4R1K1 w - - 0 1", "e2e5", 300},
+		{"6k1/8/8/4p3/3n4/2B5/1Q6/6K1 w - - 0 1", "c3d4", 100},
+		{"4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1", "e5d6", 100},
+		{"8/4k3/8/3pP3/8/8/8/4K3 w - d6 0 1", "e5d6", 0}};
+	int failures = 0;
+	for (Exchange &exchange: exchanges)
+	{
+		Position position;
+		positionFromFen(exchange.fen, position);
+		bool found = false;
+		for (Position &move: legalMoves(position))
+		{
+			Move played = moveBetween(position, move);
+			if (moveToUci(played) != exchange.move) continue;
+			found = true;
+			int value = staticExchange(position, played);
+			bool passed = value == exchange.value;
+			failures += passed ? 0 : 1;
+			std::cout << (passed ? "ok   " : "FAIL ") << exchange.fen << " " << exchange.move << ": " << value;
+			if (!passed) std::cout << ", expected " << exchange.value;
+			std::cout << std::endl;
+		}
+		if (found) continue;
+		failures++;
+		std::cout << "FAIL " << exchange.fen << " " << exchange.move << ": not a legal move" << std::endl;
+	}
+	return failures == 0 ? 0 : 1;
+}
+
+volatile long long kernelSink = 0; //keeps kernel results alive without printing them
+
+struct KernelResult
+{
+	std::string name;
+	long long ops;
+	double nanoseconds; //per op, the median of the samples
+	double allocations; //per op, over every sample
+};
+
+template <typename Prepare, typename Kernel>
+KernelResult measureKernel(const std::string &name, int samples, Prepare prepare, Kernel kernel) //prepare is untimed, kernel returns its op count
+{
+	prepare();
+	kernel(); //warm up caches and any per-thread state
+	std::vector<double> timings = {};
+	long long ops = 0;
+	long long allocations = 0;
+	for (int sample{0}; sample<samples; sample++)
+	{
+		prepare();
+		long long before = heapAllocations;
+		auto start = std::chrono::steady_clock::now();
+		long long count = kernel();
+		auto stop = std::chrono::steady_clock::now();
+		allocations += heapAllocations - before;
+		ops += count;
+		timings.push_back(std::chrono::duration<double, std::nano>(stop - start).count() / std::max(count, 1ll));
+	}
+	std::sort(timings.begin(), timings.end());
+	return {name, ops / samples, timings[timings.size()/2], static_cast<double>(allocations) / std::max(ops, 1ll)};
+}
+
+int benchKernels(int samples) //csv on stdout, one row per kernel, so runs can be compared across commits
+{
+	std::mt19937_64 random(20241019);
+	std::vector<Position> corpus = {}; //the fens and the positions of fixed random games from them
+	for (const std::string &fen: benchFens())
+	{
+		for (int game{0}; game<8; game++)
+		{
+			Position position;
+			positionFromFen(fen, position);
+			for (int ply{0}; ply<40; ply++)
+			{
+				corpus.push_back(position);
+				std::vector<Position> moves = legalMoves(position);
+				if (moves.empty()) break;
+				position = moves[random()%moves.size()];
+			}
+		}
+	}
+	std::vector<Position> children = {};
+	std::vector<GenMove> steps = {}; //a pseudo-legal move of each corpus position
+	for (Position &position: corpus)
+	{
+		MoveGenerator moveGenerator = {position, true};
+		for (Position child = moveGenerator.next(); !moveGenerator.done; child = moveGenerator.next()) children.push_back(child);
+		steps.push_back(moveGenerator.count > 0 ? moveGenerator.moves[random()%moveGenerator.count] : GenMove{0, 0, 0, 0, 0});
+	}
+	int rounds = 5;
+	std::vector<Position> scratch = {};
+	for (int round{0}; round<rounds; round++) scratch.insert(scratch.end(), corpus.begin(), corpus.end());
+	std::vector<Position> sources = scratch;
+	auto nothing = []() {};
+
+	std::vector<KernelResult> results = {};
+	results.push_back(measureKernel("MoveGenerator::next", samples, nothing, [&]() //per legal move, generating them included
+	{
+		long long moves = 0;
+		for (int round{0}; round<rounds; round++)
+		{
+			for (Position &position: corpus)
+			{
+				MoveGenerator moveGenerator = {position, false};
+				for (moveGenerator.next(); !moveGenerator.done; moveGenerator.next()) moves++;
+			}
+		}
+		kernelSink = moves;
+		return moves;
+	}));
+	results.push_back(measureKernel("isCheck", samples, nothing, [&]()
+	{
+		long long checks = 0;
+		for (int round{0}; round<rounds; round++)
+			for (Position &child: children)
+				checks += isCheck(child);
+		kernelSink = checks;
+		return static_cast<long long>(rounds * children.size());
+	}));
+	results.push_back(measureKernel("evaluateLeaf", samples, nothing, [&]()
+	{
+		float checksum = 0.f;
+		for (int round{0}; round<rounds; round++)
+			for (Position &position: corpus)
+				checksum += evaluateLeaf(position);
+		kernelSink = static_cast<long long>(checksum);
+		return static_cast<long long>(rounds * corpus.size());
+	}));
+	results.push_back(measureKernel("Position copy", samples, nothing, [&]()
+	{
+		for (int round{0}; round<rounds; round++)
+			for (std::size_t n{0}; n<corpus.size(); n++)
+				scratch[n] = corpus[(n+round+1)%corpus.size()];
+		kernelSink = scratch.back().turnPlayer;
+		return static_cast<long long>(rounds * corpus.size());
+	}));
+	results.push_back(measureKernel("Position ==", samples, nothing, [&]()
+	{
+		long long equal = 0;
+		for (int round{0}; round<rounds; round++)
+			for (std::size_t n{0}; n<corpus.size(); n++)
+				equal += corpus[n] == corpus[(n+round)%corpus.size()]; //round 0 compares equal positions all the way through
+		kernelSink = equal;
+		return static_cast<long long>(rounds * corpus.size());
+	}));
+	results.push_back(measureKernel("updateNewPosition", samples, [&]() { scratch = sources; }, [&]()
+	{
+		for (std::size_t n{0}; n<scratch.size(); n++)
+		{
+			GenMove &step = steps[n%steps.size()];
+			updateNewPosition(scratch[n], step.fromX, step.fromY, step.toX-step.fromX, step.toY-step.fromY);
+		}
+		kernelSink = scratch.back().turnPlayer;
+		return static_cast<long long>(scratch.size());
+	}));
+
+	std::cout << "kernel,ops,ns_per_op,allocs_per_op" << std::endl;
+	for (KernelResult &result: results)
+		std::cout << result.name << "," << result.ops << "," << result.nanoseconds << "," << result.allocations << std::endl;
+	return 0;
+}
+
+int benchMcts(long long playouts, int maxThreads) //playouts per second, doubling the threads up to maxThreads
+{
+	double baseline = 0.0;
+	for (int threads{1}; threads<=maxThreads; threads*=2)
+	{
+		mctsSettings.threads = threads;
+		long long total = 0;
+		double seconds = 0.0;
+		for (const std::string &fen: benchFens())
+		{
+			Position position;
+			positionFromFen(fen, position);
+			MctsReport report;
+			Position move = mctsSearch(position, playouts, 0, report);
+			total += report.playouts;
+			seconds += report.seconds;
+			if (threads == 1)
+			{
+				std::cout << fen << ": " << moveToSan(position, move) << ", " << report.visits << " visits, "
+				<< report.value << " expected, " << report.nodes << " nodes" << std::endl;
+			}
+		}
+		double rate = total / seconds;
+		if (threads == 1) baseline = rate;
+		std::cout << "threads " << threads << ": " << total << " playouts in " << seconds << "s, "
+		<< static_cast<long long>(rate) << " playouts/sec, speedup " << rate / baseline << std::endl;
+	}
+	return 0;
+}
+
+int bench(int depth) //the node count is a signature: it changes only when the search or the move generator does
+{
+	long long totalNodes = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (const std::string &fen: benchFens())
+	{
+		Position position;
+		positionFromFen(fen, position);
+		searchLimits = {};
+		Position move = generateBotMove(position, depth);
+		std::cout << fen << ": " << moveToSan(position, move) << ", " << searchLimits.nodes << " nodes" << std::endl;
+		totalNodes += searchLimits.nodes;
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << "bench: " << totalNodes << " nodes, " << seconds << "s, "
+	<< static_cast<long long>(totalNodes / std::max(seconds, 1e-9)) << " nodes/sec" << std::endl;
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc > 1 && std::string(argv[1]) == "eval")
+	{
+		return benchEval(argc > 2 ? std::stoi(argv[2]) : 100000);
+	}
+	if (argc > 1 && std::string(argv[1]) == "nnue")
+	{
+		return benchNnue(argc > 2 ? argv[2] : "", argc > 3 ? std::stoi(argv[3]) : 100000);
+	}
+	if (argc > 1 && std::string(argv[1]) == "alloc")
+	{
+		return allocationCheck(argc > 2 ? std::stoi(argv[2]) : 4);
+	}
+	if (argc > 1 && std::string(argv[1]) == "see") return exchangeCheck();
+	if (argc > 1 && std::string(argv[1]) == "mcts")
+	{
+		int threads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+		return benchMcts(argc > 2 ? std::stoll(argv[2]) : 2000, argc > 3 ? std::stoi(argv[3]) : threads);
+	}
+	if (argc > 1 && std::string(argv[1]) == "kernels") return benchKernels(argc > 2 ? std::stoi(argv[2]) : 7);
+	return bench(argc > 1 ? std::stoi(argv[1]) : 4);
+}
@@ -0,0 +1,374 @@
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../engine/notation.h"
+#include "../engine/position.h"
+
+//an independent 0x88 move generator the engine is checked against. By default it follows the engine's
+//documented rules: pawns only promote to queens and castling ignores attacked squares. --strict uses FIDE rules.
+
+const std::array<int, 8> knightOffsets = {33, 31, 18, 14, -14, -18, -31, -33};
+const std::array<int, 8> kingOffsets = {1, 15, 16, 17, -1, -15, -16, -17};
+const std::array<int, 4> bishopOffsets = {15, 17, -15, -17};
+const std::array<int, 4> rookOffsets = {1, 16, -1, -16};
+
+struct ReferenceMove
+{
+	int from;
+	int to;
+	char promotion; //lowercase piece letter, or 0
+};
+
+struct ReferenceBoard
+{
+	std::array<char, 128> squares; //FEN letters or '.', square rank*16+file with rank 0 the first rank
+	bool whiteToMove = true;
+	std::array<bool, 4> castling = {}; //K Q k q
+	int enPassant = -1;
+
+	bool load(const std::string &fen)
+	{
+		squares.fill('.');
+		std::istringstream stream(fen);
+		std::string placement, turn, rights, target;
+		if (!(stream >> placement >> turn >> rights >> target)) return false;
+		int rank = 7;
+		int file = 0;
+		for (char c: placement)
+		{
+			if (c == '/')
+			{
+				rank--;
+				file = 0;
+			}
+			else if (std::isdigit(static_cast<unsigned char>(c))) file += c-'0';
+			else squares[rank*16 + file++] = c;
+		}
+		whiteToMove = turn == "w";
+		castling = {rights.find('K') != std::string::npos, rights.find('Q') != std::string::npos,
+			rights.find('k') != std::string::npos, rights.find('q') != std::string::npos};
+		enPassant = target == "-" ? -1 : (target[1]-'1')*16 + (target[0]-'a');
+		return true;
+	}
+	std::string fen() const
+	{
+		std::string text = "";
+		for (int rank{7}; rank>=0; rank--)
+		{
+			int empty = 0;
+			for (int file{0}; file<8; file++)
+			{
+				char piece = squares[rank*16 + file];
+				if (piece == '.')
+				{
+					empty++;
+					continue;
+				}
+				if (empty) text += static_cast<char>('0'+empty);
+				empty = 0;
+				text += piece;
+			}
+			if (empty) text += static_cast<char>('0'+empty);
+			if (rank > 0) text += '/';
+		}
+		text += whiteToMove ? " w " : " b ";
+		std::string rights = "";
+		for (int i{0}; i<4; i++)
+			if (castling[i]) rights += "KQkq"[i];
+		text += rights == "" ? "-" : rights;
+		text += " " + (enPassant < 0 ? std::string("-") : squareText(enPassant));
+		return text + " 0 1";
+	}
+	static std::string squareText(int square)
+	{
+		return std::string(1, static_cast<char>('a' + (square & 7))) + static_cast<char>('1' + (square >> 4));
+	}
+	static bool white(char piece)
+	{
+		return std::isupper(static_cast<unsigned char>(piece));
+	}
+	int attackers(int square, bool byWhite) const
+	{
+		auto is = [&](int from, char piece)
+		{
+			return !(from & 0x88) && squares[from] == (byWhite ? static_cast<char>(std::toupper(piece)) : piece);
+		};
+		int count = 0;
+		int pawnRank = byWhite ? -16 : 16; //the enemy pawn sits a rank behind the square from its own side
+		count += is(square + pawnRank - 1, 'p') + is(square + pawnRank + 1, 'p');
+		for (int offset: knightOffsets)
+			count += is(square + offset, 'n');
+		for (int offset: kingOffsets)
+			count += is(square + offset, 'k');
+		for (int slider{0}; slider<2; slider++)
+		{
+			for (int offset: slider == 0 ? bishopOffsets : rookOffsets)
+			{
+				for (int to = square + offset; !(to & 0x88); to += offset)
+				{
+					if (squares[to] == '.') continue;
+					count += is(to, slider == 0 ? 'b' : 'r') || is(to, 'q');
+					break;
+				}
+			}
+		}
+		return count;
+	}
+	bool attacked(int square, bool byWhite) const
+	{
+		return attackers(square, byWhite) > 0;
+	}
+	int king(bool whiteKing) const
+	{
+		for (int square{0}; square<128; square++)
+			if (!(square & 0x88) && squares[square] == (whiteKing ? 'K' : 'k')) return square;
+		return -1;
+	}
+	bool inCheck(bool whiteKing) const
+	{
+		int square = king(whiteKing);
+		return square < 0 || attacked(square, !whiteKing);
+	}
+	void pseudoLegal(std::vector<ReferenceMove> &moves, bool strict) const
+	{
+		bool us = whiteToMove;
+		auto enemy = [&](int square)
+		{
+			return squares[square] != '.' && white(squares[square]) != us;
+		};
+		for (int from{0}; from<128; from++)
+		{
+			if (from & 0x88 || squares[from] == '.' || white(squares[from]) != us) continue;
+			char piece = static_cast<char>(std::tolower(squares[from]));
+			if (piece == 'p')
+			{
+				int forward = us ? 16 : -16;
+				int lastRank = us ? 7 : 0;
+				auto push = [&](int to)
+				{
+					if ((to >> 4) != lastRank) moves.push_back({from, to, 0});
+					else for (char promotion: strict ? std::string("qrbn") : std::string("q")) moves.push_back({from, to, promotion});
+				};
+				int ahead = from + forward;
+				if (!(ahead & 0x88) && squares[ahead] == '.')
+				{
+					push(ahead);
+					if ((from >> 4) == (us ? 1 : 6) && squares[ahead + forward] == '.') moves.push_back({from, ahead + forward, 0});
+				}
+				for (int side: {-1, 1})
+				{
+					int to = ahead + side;
+					if (to & 0x88) continue;
+					if (enemy(to)) push(to);
+					else if (to == enPassant) moves.push_back({from, to, 0});
+				}
+				continue;
+			}
+			bool slider = piece == 'b' || piece == 'r' || piece == 'q';
+			std::vector<int> offsets = {};
+			if (piece == 'n') offsets.assign(knightOffsets.begin(), knightOffsets.end());
+			if (piece == 'k' || piece == 'q') offsets.assign(kingOffsets.begin(), kingOffsets.end());
+			if (piece == 'b') offsets.assign(bishopOffsets.begin(), bishopOffsets.end());
+			if (piece == 'r') offsets.assign(rookOffsets.begin(), rookOffsets.end());
+			for (int offset: offsets)
+			{
+				for (int to = from + offset; !(to & 0x88); to += offset)
+				{
+					if (squares[to] != '.' && !enemy(to)) break;
+					moves.push_back({from, to, 0});
+					if (squares[to] != '.' || !slider) break;
+				}
+			}
+			if (piece != 'k') continue;
+			int home = us ? 4 : 0x74;
+			if (from != home) continue;
+			bool kingside = castling[us ? 0 : 2] && squares[home+1] == '.' && squares[home+2] == '.';
+			bool queenside = castling[us ? 1 : 3] && squares[home-1] == '.' && squares[home-2] == '.' && squares[home-3] == '.';
+			if (strict)
+			{
+				bool safe = !attacked(home, !us);
+				kingside = kingside && safe && !attacked(home+1, !us);
+				queenside = queenside && safe && !attacked(home-1, !us);
+			}
+			if (kingside) moves.push_back({from, home+2, 0});
+			if (queenside) moves.push_back({from, home-2, 0});
+		}
+	}
+	ReferenceBoard play(const ReferenceMove &move) const
+	{
+		ReferenceBoard next = *this;
+		char piece = static_cast<char>(std::tolower(squares[move.from]));
+		next.squares[move.to] = squares[move.from];
+		next.squares[move.from] = '.';
+		if (move.promotion) next.squares[move.to] = whiteToMove ? static_cast<char>(std::toupper(move.promotion)) : move.promotion;
+		if (piece == 'p' && move.to == enPassant) next.squares[move.to + (whiteToMove ? -16 : 16)] = '.';
+		if (piece == 'k' && move.to - move.from == 2) std::swap(next.squares[move.from+1], next.squares[move.from+3]);
+		if (piece == 'k' && move.from - move.to == 2) std::swap(next.squares[move.from-1], next.squares[move.from-4]);
+		next.enPassant = piece == 'p' && std::abs(move.to - move.from) == 32 ? (move.from + move.to) / 2 : -1;
+		next.whiteToMove = !whiteToMove;
+		std::array<std::array<int, 2>, 4> homes = {{{4, 7}, {4, 0}, {0x74, 0x77}, {0x74, 0x70}}}; //king and rook squares for K Q k q
+		for (int i{0}; i<4; i++) //a right goes once its king or rook has left home, however that happened
+		{
+			bool whiteRight = i < 2;
+			if (next.squares[homes[i][0]] != (whiteRight ? 'K' : 'k') || next.squares[homes[i][1]] != (whiteRight ? 'R' : 'r'))
+				next.castling[i] = false;
+		}
+		return next;
+	}
+	std::map<std::string, std::string> legal(bool strict) const //UCI move to the FEN it leads to
+	{
+		std::vector<ReferenceMove> moves = {};
+		pseudoLegal(moves, strict);
+		std::map<std::string, std::string> result = {};
+		for (ReferenceMove &move: moves)
+		{
+			ReferenceBoard next = play(move);
+			if (next.inCheck(whiteToMove)) continue;
+			std::string uci = squareText(move.from) + squareText(move.to);
+			if (move.promotion) uci += move.promotion;
+			result[uci] = next.fen();
+		}
+		return result;
+	}
+};
+
+std::string compare(Position &position, bool strict, std::string &move) //empty when the engine and the reference agree
+{
+	ReferenceBoard reference;
+	std::string fen = fenFromPosition(position);
+	if (!reference.load(fen)) return "reference could not read " + fen;
+	std::map<std::string, std::string> engineMoves = {};
+	MoveGenerator moveGenerator = {position, false};
+	for (Position child = moveGenerator.next(); !moveGenerator.done; child = moveGenerator.next())
+		engineMoves[moveToUci(moveBetween(position, child))] = fenFromPosition(child);
+	std::map<std::string, std::string> referenceMoves = reference.legal(strict);
+	for (auto &entry: referenceMoves)
+	{
+		move = entry.first;
+		auto found = engineMoves.find(entry.first);
+		if (found == engineMoves.end()) return "engine is missing the move";
+		if (found->second != entry.second) return "engine plays it to " + found->second + ", reference to " + entry.second;
+	}
+	for (auto &entry: engineMoves)
+	{
+		move = entry.first;
+		if (!referenceMoves.count(entry.first)) return "engine has an extra move";
+	}
+	int king = reference.king(reference.whiteToMove);
+	for (int i{0}; king >= 0 && reference.attackers(king, !reference.whiteToMove) > 1 && i<moveGenerator.count; i++)
+	{
+		const GenMove &generated = moveGenerator.moves[i]; //only the king can answer a double check, so nothing else should be generated
+		move = moveToUci({{generated.fromX, generated.fromY}, {generated.toX, generated.toY}, '\0'});
+		if (position[generated.fromX][generated.fromY][0] != 'k') return "engine generates a non-king move in a double check";
+	}
+	move = "";
+	Position toggled = position;
+	toggled.toggleTurn();
+	bool engineCheck = isCheck(toggled);
+	if (engineCheck != reference.inCheck(reference.whiteToMove))
+		return std::string("engine says the side to move is ") + (engineCheck ? "" : "not ") + "in check";
+	return "";
+}
+
+void dropStaleRights(Position &position) //castling and en passant rights that pieces no longer back up
+{
+	for (char player: {'l', 'd'})
+	{
+		int row = player == 'l' ? 7 : 0;
+		auto &rights = position.castlingRights[player];
+		if (position[row][4] != std::string("k") + player) rights = {false, false, false};
+		if (position[row][0] != std::string("r") + player) rights[1] = false;
+		if (position[row][7] != std::string("r") + player) rights[2] = false;
+		rights[0] = rights[0] && (rights[1] || rights[2]);
+	}
+	if (position.enPassantAllowed)
+	{
+		int pawnRow = position.enPassantSquare[0] + (position.turnPlayer == 'l' ? 1 : -1);
+		char mover = position.turnPlayer == 'l' ? 'd' : 'l';
+		if (position[pawnRow][position.enPassantSquare[1]] != std::string("p") + mover
+		|| position[position.enPassantSquare[0]][position.enPassantSquare[1]] != "") position.enPassantAllowed = false;
+	}
+}
+
+Position minimise(Position position, bool strict) //removes pieces one at a time while the difference remains
+{
+	std::string move;
+	bool removed = true;
+	while (removed)
+	{
+		removed = false;
+		for (int x{0}; x<8; x++)
+		{
+			for (int y{0}; y<8; y++)
+			{
+				if (position[x][y] == "" || position[x][y][0] == 'k') continue;
+				Position candidate = position;
+				candidate[x][y] = "";
+				dropStaleRights(candidate);
+				if (isCheck(candidate) || compare(candidate, strict, move) == "") continue; //the side that just moved may not be left in check
+				position = candidate;
+				removed = true;
+			}
+		}
+	}
+	return position;
+}
+
+int main(int argc, char *argv[])
+{
+	int games = 1000;
+	int maxPlies = 200;
+	uint64_t seed = std::random_device{}();
+	bool strict = false;
+	for (int arg{1}; arg<argc; arg++)
+	{
+		std::string option = argv[arg];
+		if (option == "--strict") strict = true;
+		else if (arg+1 >= argc) break;
+		else if (option == "--games") games = std::stoi(argv[++arg]);
+		else if (option == "--plies") maxPlies = std::stoi(argv[++arg]);
+		else if (option == "--seed") seed = std::stoull(argv[++arg]);
+	}
+	std::vector<std::string> openings = {startFen,
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+		"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+		"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+		"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+		"r3k2r/ppp2ppp/3N4/8/8/8/PPP2PPP/4R1K1 b - - 0 1"}; //double check, c7 could only take the knight if it were a single check
+	std::mt19937_64 random(seed);
+	long long positions = 0;
+	for (int game{0}; game<games; game++)
+	{
+		Position position;
+		positionFromFen(openings[game % openings.size()], position);
+		for (int ply{0}; ply<maxPlies; ply++)
+		{
+			std::string move;
+			std::string difference = compare(position, strict, move);
+			positions++;
+			if (difference != "")
+			{
+				std::cout << "difference in game " << game << " (seed " << seed << ") at " << fenFromPosition(position)
+				<< (move == "" ? "" : " move " + move) << ": " << difference << std::endl;
+				Position small = minimise(position, strict);
+				difference = compare(small, strict, move);
+				std::cout << "minimised: " << fenFromPosition(small) << (move == "" ? "" : " move " + move) << ": " << difference << std::endl;
+				return 1;
+			}
+			std::vector<Position> moves = legalMoves(position);
+			if (moves.empty()) break;
+			position = moves[random() % moves.size()];
+		}
+	}
+	std::cout << games << " games, " << positions << " positions, no differences from the "
+	<< (strict ? "FIDE" : "engine's") << " rules (seed " << seed << ")" << std::endl;
+	return 0;
+}
@@ -0,0 +1,340 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+#include "atlas.h"
+
+#include "../engine/cache.h"
+#include "../engine/mcts.h"
+#include "../engine/nnue.h"
+#include "../engine/notation.h"
+#include "../engine/pgn.h"
+#include "../engine/position.h"
+#include "../engine/search.h"
+
+sf::Mutex spritesMutex;
+sf::Mutex mousePressMutex;
+sf::Mutex positionMutex;
+
+struct MousePress
+{
+	std::array<int, 2> initialPosition;
+	bool pressed;
+	uint64_t targets; //squares the pressed piece can legally move to, bit x*8+y
+};
+
+struct LegalMoveTable //legal moves of the position on the board, built once per turn
+{
+	std::vector<Position> moves;
+	std::array<std::array<int16_t, 64>, 64> index; //into moves by from and to square, -1 if illegal; positions can have over 127 moves
+	std::array<uint64_t, 64> targets; //by from square
+
+	void build(Position &position)
+	{
+		moves = legalMoves(position);
+		for (auto &row: index) row.fill(-1);
+		targets.fill(0);
+		for (std::size_t i{0}; i<moves.size(); i++)
+		{
+			Move move = moveBetween(position, moves[i]);
+			int from = move.from[0]*8 + move.from[1];
+			int to = move.to[0]*8 + move.to[1];
+			index[from][to] = static_cast<int16_t>(i); //promotions are always to a queen, so from and to are unique
+			targets[from] |= 1ull << to;
+		}
+	}
+	const Position *find(std::array<int, 2> from, std::array<int, 2> to) const
+	{
+		if (std::min({from[0], from[1], to[0], to[1]}) < 0 || std::max({from[0], from[1], to[0], to[1]}) > 7) return nullptr;
+		int i = index[from[0]*8 + from[1]][to[0]*8 + to[1]];
+		return i < 0 ? nullptr : &moves[i];
+	}
+	uint64_t targetsFrom(std::array<int, 2> from) const
+	{
+		if (std::min(from[0], from[1]) < 0 || std::max(from[0], from[1]) > 7) return 0;
+		return targets[from[0]*8 + from[1]];
+	}
+};
+
+struct AtlasLoad //the embedded sprites, decoded off the main thread while the difficulty prompt waits
+{
+	sf::Image image;
+	bool loaded = true;
+	double milliseconds = 0.0;
+};
+
+void decodeAtlas(AtlasLoad &atlas)
+{
+	auto start = std::chrono::steady_clock::now();
+	atlas.image.create(atlasWidth, atlasHeight, sf::Color::Transparent);
+	for (std::size_t n{0}; n<atlasSpriteCount; n++)
+	{
+		sf::Image image;
+		if (!image.loadFromMemory(atlasSprites[n].data, atlasSprites[n].size)) atlas.loaded = false;
+		else atlas.image.copy(image, atlasSprites[n].x, atlasSprites[n].y);
+	}
+	atlas.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct StartupTimes //for reporting the time to the first frame
+{
+	std::chrono::steady_clock::time_point launched;
+	std::chrono::steady_clock::time_point answered; //the difficulty prompt, which waits on the player
+	double decodeMilliseconds;
+};
+
+struct RenderThreadParam
+{
+	sf::RenderWindow &root;
+	Position &position;
+	std::map<std::string, sf::Sprite> &sprites;
+	MousePress &mousePress;
+	StartupTimes &startup;
+};
+
+void renderingThread(RenderThreadParam param)
+{
+	sf::RenderWindow &root = param.root;
+	Position &position = param.position;
+	std::map<std::string, sf::Sprite> &sprites = param.sprites;
+	MousePress &mousePress = param.mousePress;
+	StartupTimes &startup = param.startup;
+	bool firstFrame = true;
+
+	root.setActive(true);
+
+	while (root.isOpen())
+	{
+		root.clear(sf::Color::Green);
+		spritesMutex.lock();
+		mousePressMutex.lock();
+		root.draw(sprites["board"]);
+
+		if (mousePress.pressed)
+		{
+			sf::CircleShape marker(7.5f);
+			marker.setFillColor(sf::Color(0, 0, 0, 80));
+			for (int square{0}; square<64; square++)
+			{
+				if (!(mousePress.targets >> square & 1)) continue;
+				marker.setPosition(square%8*45.f + 15.f, square/8*45.f + 15.f);
+				root.draw(marker);
+			}
+		}
+	
+		for (int x{0}; x<8; x++)
+		{
+			for (int y{0}; y<8; y++)
+			{
+				if (position[x][y] != "")
+				{
+					if (mousePress.pressed 
+					&& mousePress.initialPosition[0] == x 
+					&& mousePress.initialPosition[1] == y)
+					{
+						auto mousePosition = sf::Mouse::getPosition(root);
+						sprites[position[x][y]].setPosition(mousePosition.x-22.5f, mousePosition.y-22.5f);
+					}
+					else
+
+					{
+						sprites[position[x][y]].setPosition(y*45.f, x*45.f);
+					}
+					root.draw(sprites[position[x][y]]);
+				}
+			}
+		}
+		spritesMutex.unlock();
+		mousePressMutex.unlock();
+		root.display();
+		if (firstFrame)
+		{
+			auto now = std::chrono::steady_clock::now();
+			std::cout << "first frame " << std::chrono::duration<double, std::milli>(now - startup.answered).count()
+			<< "ms after the difficulty prompt, " << std::chrono::duration<double, std::milli>(now - startup.launched).count()
+			<< "ms after launch (sprites decoded in " << startup.decodeMilliseconds << "ms)" << std::endl;
+			firstFrame = false;
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	StartupTimes startup = {std::chrono::steady_clock::now(), {}, 0.0};
+	AtlasLoad atlas;
+	std::thread decoder(decodeAtlas, std::ref(atlas));
+	std::string pgnPath = "games.pgn";
+	std::string cachePath = "";
+	for (int arg{1}; arg+1<argc; arg++)
+	{
+		if (std::string(argv[arg]) == "--nnue" && !loadNetwork(argv[arg+1]))
+		{
+			std::cout << "could not load network " << argv[arg+1] << ", using the classic evaluation" << std::endl;
+		}
+		if (std::string(argv[arg]) == "--pgn") pgnPath = argv[arg+1];
+		if (std::string(argv[arg]) == "--cache") cachePath = argv[arg+1];
+		if (std::string(argv[arg]) == "--mcts") //threads
+		{
+			mctsSettings.enabled = true;
+			mctsSettings.threads = std::max(std::stoi(argv[arg+1]), 1);
+		}
+	}
+	AnalysisCache cache;
+	if (cachePath != "")
+	{
+		if (cache.open(cachePath, 16)) analysisCache = &cache;
+		std::cout << cache.status << std::endl;
+	}
+
+	std::array<std::array<std::string, 8>, 8> board = {"rd", "nd", "bd", "qd", "kd", "bd", "nd", "rd",
+								   					   "pd", "pd", "pd", "pd", "pd", "pd", "pd", "pd",
+														 "",   "",   "",   "",   "",   "",   "",   "",
+														 "",   "",   "",   "",   "",   "",   "",   "",
+														 "",   "",   "",   "",   "",   "",   "",   "",
+														 "",   "",   "",   "",   "",   "",   "",   "",
+	   							   					   "pl", "pl", "pl", "pl", "pl", "pl", "pl", "pl",
+							   						   "rl", "nl", "bl", "ql", "kl", "bl", "nl", "rl",
+	};
+
+	/*std::array<std::array<std::string, 8>, 8> board = {"kd", "", "", "", "", "rd", "", "",
+														 "",   "",   "",   "",   "",   "",   "rd",   "",
+														 "",   "",   "",   "",   "",   "",   "",   "",
+														 "",   "",   "",   "",   "",   "",   "",   "",
+														 "",   "",   "",   "",   "",   "",   "",   "",
+														 "",   "",   "",   "",   "",   "",   "",   "",
+														 "",   "",   "",   "",   "",   "",   "",   "",
+							   						   "", "", "", "", "", "", "", "kl",
+	};*/
+
+	Position position = {board, {{'l', {true, true, true}}, {'d', {true, true, true}}}, 'l', false, {0, 0}};
+	GameRecord gameRecord = {startFen, {}, "*", ""};
+
+	MousePress mousePress = {{0,0}, false, 0};
+	LegalMoveTable legal;
+	legal.build(position);
+
+	std::cout << "Difficulty (type a number): " << std::endl;
+
+	for (std::size_t level{0}; level<difficultyProfiles.size(); level++)
+	{
+		DifficultyProfile &profile = difficultyProfiles[level];
+		std::cout << "(" << level+1 << ") " << profile.name << " (up to " << profile.timeBudget/1000.f << "s a move)" << std::endl;
+	}
+
+	std::string temp;
+	std::getline(std::cin, temp);
+
+	int difficulty = 4;
+
+	for (char &e: temp)
+		if ('0' < e && e <= '0' + static_cast<int>(difficultyProfiles.size()))
+			difficulty = e - '0';
+	std::mt19937_64 random(std::random_device{}());
+	startup.answered = std::chrono::steady_clock::now();
+
+	decoder.join();
+	if (!atlas.loaded)
+	{
+		std::cout << "could not decode the embedded sprites" << std::endl;
+		return 1;
+	}
+	startup.decodeMilliseconds = atlas.milliseconds;
+	sf::Texture texture;
+	texture.loadFromImage(atlas.image);
+	std::map<std::string, sf::Sprite> sprites = {};
+	for (std::size_t n{0}; n<atlasSpriteCount; n++)
+	{
+		const AtlasSprite &sprite = atlasSprites[n];
+		sprites[sprite.name] = sf::Sprite(texture, sf::IntRect(sprite.x, sprite.y, sprite.width, sprite.height));
+	}
+
+	sf::RenderWindow root(sf::VideoMode(360, 360), "Chess");
+
+	root.setActive(false);
+
+	RenderThreadParam renderParam = {root, position, sprites, mousePress, startup};
+	sf::Thread renderThread(&renderingThread, renderParam);
+	renderThread.launch();
+
+	while (root.isOpen())
+	{
+		sf::Event event; 
+		while (root.pollEvent(event))
+		{
+			if (event.type == sf::Event::Closed)
+			{
+				root.close();
+			}
+			if (event.type == sf::Event::MouseButtonPressed)
+			{
+				if (event.mouseButton.button == sf::Mouse::Left)
+				{
+					mousePressMutex.lock();
+					mousePress.pressed = true;
+					auto mousePosition = sf::Mouse::getPosition(root);
+					mousePress.initialPosition = {static_cast<int>(mousePosition.y/45.f),
+												  static_cast<int>(mousePosition.x/45.f)};
+					mousePress.targets = legal.targetsFrom(mousePress.initialPosition);
+					mousePressMutex.unlock();
+				}
+			}
+			if (event.type == sf::Event::MouseButtonReleased)
+			{
+				if (event.mouseButton.button == sf::Mouse::Left)
+				{		
+					auto mousePosition = sf::Mouse::getPosition(root);
+					std::array<int, 2> finalPosition = {std::min(std::max(static_cast<int>(mousePosition.y/45.f), 0), 7),
+												  		std::min(std::max(static_cast<int>(mousePosition.x/45.f), 0), 7)};
+					mousePressMutex.lock();
+					mousePress.targets = 0;
+					mousePressMutex.unlock();
+					const Position *move = legal.find(mousePress.initialPosition, finalPosition);
+					if (move)
+					{
+						Position newPosition = *move;
+						positionMutex.lock();
+						gameRecord.moves.push_back(moveToSan(position, newPosition));
+						position = newPosition;
+						//auto start = std::chrono::high_resolution_clock::now();
+						Position botMove = generateBotMove(position, difficultyProfiles[difficulty-1], random);
+						if (!(botMove == position)) gameRecord.moves.push_back(moveToSan(position, botMove));
+						position = botMove;
+						/*auto stop = std::chrono::high_resolution_clock::now(); 
+						std::cout << std::chrono::duration_cast<std::chrono::microseconds>(stop - start).count() << std::endl;*/
+						positionMutex.unlock();
+						legal.build(position);
+					}
+					mousePressMutex.lock();
+					mousePress.pressed = false;
+					mousePressMutex.unlock();	
+				}
+			}
+		}
+	}
+
+	if (!gameRecord.moves.empty())
+	{
+		if (legalMoves(position).empty())
+		{
+			position.toggleTurn();
+			bool mate = isCheck(position);
+			position.toggleTurn();
+			gameRecord.result = !mate ? "1/2-1/2" : position.turnPlayer == 'l' ? "0-1" : "1-0";
+		}
+		std::ofstream pgn(pgnPath, std::ios::app);
+		pgn << gameToPgn(gameRecord, "Casual game", 1, "Player", "Computer (level " + std::to_string(difficulty) + ")");
+	}
+	analysisCache = nullptr;
+	return 0;
+}
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+struct SpriteFile
+{
+	std::string name;
+	std::vector<unsigned char> data;
+	int width;
+	int height;
+	int x;
+	int y;
+};
+
+bool readPng(const std::string &path, SpriteFile &sprite) //only the size is read here, the GUI decodes the pixels
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file) return false;
+	sprite.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	const std::vector<unsigned char> signature = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+	if (sprite.data.size() < 24 || !std::equal(signature.begin(), signature.end(), sprite.data.begin())) return false;
+	auto big = [&sprite](int offset)
+	{
+		return sprite.data[offset] << 24 | sprite.data[offset+1] << 16 | sprite.data[offset+2] << 8 | sprite.data[offset+3];
+	};
+	sprite.width = big(16); //IHDR is always the first chunk
+	sprite.height = big(20);
+	std::size_t slash = path.find_last_of('/');
+	std::string fileName = slash == std::string::npos ? path : path.substr(slash+1);
+	sprite.name = fileName.substr(0, fileName.rfind('.'));
+	return sprite.width > 0 && sprite.height > 0;
+}
+
+int main(int argc, char *argv[]) //writes the atlas source for the PNGs given to stdout
+{
+	std::vector<SpriteFile> sprites = {};
+	for (int arg{1}; arg<argc; arg++)
+	{
+		SpriteFile sprite;
+		if (!readPng(argv[arg], sprite))
+		{
+			std::cerr << "pack-sprites: " << argv[arg] << " is not a PNG" << std::endl;
+			return 1;
+		}
+		sprites.push_back(sprite);
+	}
+
+	//shelves of decreasing height, as wide as the widest sprite
+	std::vector<int> order(sprites.size());
+	for (std::size_t n{0}; n<order.size(); n++) order[n] = static_cast<int>(n);
+	std::stable_sort(order.begin(), order.end(), [&sprites](int a, int b) { return sprites[a].height > sprites[b].height; });
+	int width = 0;
+	for (SpriteFile &sprite: sprites) width = std::max(width, sprite.width);
+	int x = 0;
+	int y = 0;
+	int shelf = 0;
+	for (int n: order)
+	{
+		SpriteFile &sprite = sprites[n];
+		if (x + sprite.width > width)
+		{
+			x = 0;
+			y += shelf;
+			shelf = 0;
+		}
+		sprite.x = x;
+		sprite.y = y;
+		x += sprite.width;
+		shelf = std::max(shelf, sprite.height);
+	}
+
+	std::cout << "//generated by pack-sprites, do not edit" << std::endl;
+	std::cout << "#include \"atlas.h\"" << std::endl << std::endl;
+	for (std::size_t n{0}; n<sprites.size(); n++)
+	{
+		std::cout << "static const unsigned char sprite" << n << "[] = {";
+		for (std::size_t i{0}; i<sprites[n].data.size(); i++)
+			std::cout << (i % 16 == 0 ? "\n\t" : " ") << static_cast<int>(sprites[n].data[i]) << ",";
+		std::cout << "\n};" << std::endl << std::endl;
+	}
+	std::cout << "const int atlasWidth = " << width << ";" << std::endl;
+	std::cout << "const int atlasHeight = " << y + shelf << ";" << std::endl;
+	std::cout << "const AtlasSprite atlasSprites[] = {" << std::endl;
+	for (std::size_t n{0}; n<sprites.size(); n++)
+	{
+		SpriteFile &sprite = sprites[n];
+		std::cout << "\t{\"" << sprite.name << "\", sprite" << n << ", sizeof(sprite" << n << "), "
+		<< sprite.x << ", " << sprite.y << ", " << sprite.width << ", " << sprite.height << "}," << std::endl;
+	}
+	std::cout << "};" << std::endl;
+	std::cout << "const std::size_t atlasSpriteCount = " << sprites.size() << ";" << std::endl;
+	return 0;
+}
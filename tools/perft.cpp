@@ -0,0 +1,61 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../engine/notation.h"
+#include "../engine/perft.h"
+#include "../engine/position.h"
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2)
+	{
+		std::cout << "usage: chess-perft <depth> [--fen fen] [--threads n] [--split d] [--hash mb] [--scaling]" << std::endl;
+		return 1;
+	}
+	int depth = std::stoi(argv[1]);
+	std::string fen = startFen;
+	int threads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+	int splitDepth = 2;
+	int hashSize = 0;
+	bool scaling = false;
+	for (int arg{2}; arg<argc; arg++)
+	{
+		std::string option = argv[arg];
+		if (option == "--scaling") scaling = true;
+		else if (arg+1 >= argc) break;
+		else if (option == "--fen") fen = argv[++arg];
+		else if (option == "--threads") threads = std::max(std::stoi(argv[++arg]), 1);
+		else if (option == "--split") splitDepth = std::max(std::stoi(argv[++arg]), 1);
+		else if (option == "--hash") hashSize = std::stoi(argv[++arg]);
+	}
+	Position position;
+	if (!positionFromFen(fen, position))
+	{
+		std::cout << "invalid fen " << fen << std::endl;
+		return 1;
+	}
+	std::vector<int> counts = {threads};
+	if (scaling)
+	{
+		counts = {};
+		for (int count{1}; count<threads; count*=2) counts.push_back(count);
+		counts.push_back(threads);
+	}
+	double baseline = 0.0;
+	for (int count: counts)
+	{
+		PerftHash hash(hashSize);
+		auto start = std::chrono::steady_clock::now();
+		long long nodes = parallelPerft(position, depth, splitDepth, count, hash);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		double nps = nodes / std::max(seconds, 1e-9);
+		if (baseline == 0.0) baseline = nps;
+		std::cout << "threads " << count << ": " << nodes << " nodes in " << seconds << "s, "
+		<< static_cast<long long>(nps) << " nodes/sec, speedup " << nps / baseline << std::endl;
+	}
+	return 0;
+}
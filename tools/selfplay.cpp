@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../engine/match.h"
+#include "../engine/nnue.h"
+#include "../engine/notation.h"
+#include "../engine/pgn.h"
+
+int main(int argc, char *argv[])
+{
+	EngineConfig first;
+	first.name = "engine1";
+	EngineConfig second;
+	second.name = "engine2";
+	int games = 100;
+	int threads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+	int maxPlies = 400;
+	std::string openingsPath = "";
+	std::string pgnPath = "selfplay.pgn";
+	double elo0 = 0.0;
+	double elo1 = 10.0;
+	double alpha = 0.05;
+	double beta = 0.05;
+	for (int arg{1}; arg+1<argc; arg+=2)
+	{
+		std::string option = argv[arg];
+		std::string value = argv[arg+1];
+		bool valid = true;
+		if (option == "--engine1") valid = parseEngineConfig(value, first);
+		else if (option == "--engine2") valid = parseEngineConfig(value, second);
+		else if (option == "--games") games = std::stoi(value);
+		else if (option == "--threads") threads = std::max(std::stoi(value), 1);
+		else if (option == "--max-plies") maxPlies = std::stoi(value);
+		else if (option == "--openings") openingsPath = value;
+		else if (option == "--pgn") pgnPath = value;
+		else if (option == "--elo0") elo0 = std::stod(value);
+		else if (option == "--elo1") elo1 = std::stod(value);
+		else if (option == "--alpha") alpha = std::stod(value);
+		else if (option == "--beta") beta = std::stod(value);
+		else if (option == "--nnue") valid = loadNetwork(value);
+		else valid = false;
+		if (!valid)
+		{
+			std::cout << "invalid option " << option << " " << value << std::endl;
+			return 1;
+		}
+	}
+
+	std::vector<std::string> openings = {};
+	if (openingsPath != "")
+	{
+		std::ifstream file(openingsPath);
+		std::string line;
+		Position check;
+		while (std::getline(file, line))
+			if (positionFromFen(line, check)) openings.push_back(line);
+	}
+	if (openings.empty()) openings.push_back(startFen);
+
+	std::ofstream pgn(pgnPath, std::ios::app);
+	double lower = std::log(beta / (1-alpha));
+	double upper = std::log((1-beta) / alpha);
+	MatchScore score;
+	std::mutex scoreMutex;
+	std::atomic<int> nextGame{0};
+	std::atomic<bool> stop{false};
+
+	auto worker = [&]()
+	{
+		while (!stop)
+		{
+			int game = nextGame++;
+			if (game >= games) break;
+			bool firstIsLight = game%2 == 0; //each opening is played with both colours
+			std::string fen = openings[(game/2) % openings.size()];
+			EngineConfig lightConfig = firstIsLight ? first : second;
+			EngineConfig darkConfig = firstIsLight ? second : first;
+			GameRecord record = playGame(fen, lightConfig, darkConfig, maxPlies);
+
+			std::lock_guard<std::mutex> lock(scoreMutex);
+			if (record.result == "1/2-1/2") score.draws++;
+			else if ((record.result == "1-0") == firstIsLight) score.wins++;
+			else score.losses++;
+			pgn << gameToPgn(record, "selfplay", game+1, lightConfig.name, darkConfig.name) << std::flush;
+			double llr = sprtLlr(score, elo0, elo1);
+			std::cout << "game " << game+1 << ": " << record.result << " (" << record.termination << ")  +"
+			<< score.wins << " -" << score.losses << " =" << score.draws << "  llr " << llr << std::endl;
+			if (llr <= lower || llr >= upper) stop = true;
+		}
+	};
+	std::vector<std::thread> pool = {};
+	for (int thread{0}; thread<threads; thread++) pool.emplace_back(worker);
+	for (std::thread &thread: pool) thread.join();
+
+	if (score.games() == 0) return 0;
+	double error = 1.96 * std::sqrt(score.variance() / score.games());
+	double llr = sprtLlr(score, elo0, elo1);
+	std::cout << first.name << " vs " << second.name << ": +" << score.wins << " -" << score.losses << " =" << score.draws
+	<< " (" << score.games() << " games)" << std::endl;
+	std::cout << "elo " << eloFromScore(score.score()) << " [" << eloFromScore(score.score() - error)
+	<< ", " << eloFromScore(score.score() + error) << "]" << std::endl;
+	std::cout << "sprt elo0=" << elo0 << " elo1=" << elo1 << " llr " << llr << " bounds [" << lower << ", " << upper << "] "
+	<< (llr >= upper ? "H1 accepted" : llr <= lower ? "H0 accepted" : "inconclusive") << std::endl;
+	return 0;
+}
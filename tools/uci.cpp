@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "../engine/cache.h"
+#include "../engine/nnue.h"
+#include "../engine/notation.h"
+#include "../engine/position.h"
+#include "../engine/search.h"
+
+bool playUciMove(Position &position, const std::string &text)
+{
+	for (Position &move: legalMoves(position))
+	{
+		if (moveToUci(moveBetween(position, move)) != text) continue;
+		position = move;
+		return true;
+	}
+	return false;
+}
+
+std::string uciScore(float value, char turnPlayer, int depth) //from the side to move, mates in moves
+{
+	if (turnPlayer == 'd') value = -value;
+	if (std::abs(value) < 5000.f) return "cp " + std::to_string(static_cast<int>(std::lround(value * 100.f)));
+	int plies = depth - static_cast<int>(std::abs(value) - 5000.f);
+	int moves = (plies + 1) / 2;
+	return "mate " + std::to_string(value > 0 ? moves : -moves);
+}
+
+void uciGo(Position &position, std::istringstream &stream)
+{
+	int maxDepth = 0;
+	long long nodes = 0;
+	long long moveTime = 0;
+	long long time = 0;
+	long long increment = 0;
+	int movesToGo = 30;
+	std::string token;
+	while (stream >> token)
+	{
+		long long value = 0;
+		if (token == "infinite" || !(stream >> value)) continue;
+		if (token == "depth") maxDepth = static_cast<int>(value);
+		else if (token == "nodes") nodes = value;
+		else if (token == "movetime") moveTime = value;
+		else if (token == (position.turnPlayer == 'l' ? "wtime" : "btime")) time = value;
+		else if (token == (position.turnPlayer == 'l' ? "winc" : "binc")) increment = value;
+		else if (token == "movestogo") movesToGo = std::max(static_cast<int>(value), 1);
+	}
+	if (moveTime == 0 && time > 0) moveTime = std::max(time / movesToGo + increment / 2, 1ll);
+	if (maxDepth == 0) maxDepth = moveTime > 0 || nodes > 0 ? 64 : 4; //there is no stop command, so an unbounded go searches a fixed depth
+
+	CachedResult cached;
+	if (analysisCache && analysisCache->probe(cacheKey(position), cached) && cached.depth >= maxDepth)
+	{
+		for (Position &move: legalMoves(position))
+		{
+			if (!(moveBetween(position, move) == cached.move)) continue;
+			std::cout << "info depth " << cached.depth << " score " << uciScore(cached.value, position.turnPlayer, cached.depth)
+			<< " nodes 0 time 0 pv " << moveToUci(cached.move) << std::endl;
+			std::cout << "bestmove " << moveToUci(cached.move) << std::endl;
+			return;
+		}
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	RootMoves moves = iterativeDeepening(position, maxDepth, 1, nodes, moveTime, [&](int depth, RootMoves &deeper)
+	{
+		if (analysisCache) analysisCache->store(cacheKey(position), {depth, deeper[0].value, deeper[0].pv[0]});
+		auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+		std::cout << "info depth " << depth << " score " << uciScore(deeper[0].value, position.turnPlayer, depth)
+		<< " nodes " << searchLimits.nodes << " time " << elapsed << " pv";
+		for (Move &move: deeper[0].pv) std::cout << " " << moveToUci(move);
+		std::cout << std::endl;
+	});
+	if (moves.empty()) std::cout << "bestmove 0000" << std::endl;
+	else std::cout << "bestmove " << moveToUci(moves[0].pv[0]) << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+	AnalysisCache cache;
+	for (int arg{1}; arg+1<argc; arg++)
+	{
+		if (std::string(argv[arg]) == "--nnue" && !loadNetwork(argv[arg+1]))
+		{
+			std::cout << "could not load network " << argv[arg+1] << ", using the classic evaluation" << std::endl;
+		}
+		if (std::string(argv[arg]) == "--cache")
+		{
+			if (cache.open(argv[arg+1], 16)) analysisCache = &cache;
+			std::cout << "info string " << cache.status << std::endl;
+		}
+	}
+	Position position;
+	positionFromFen(startFen, position);
+	std::string line;
+	while (std::getline(std::cin, line))
+	{
+		std::istringstream stream(line);
+		std::string command;
+		stream >> command;
+		if (command == "uci")
+		{
+			std::cout << "id name chess" << std::endl;
+			std::cout << "uciok" << std::endl;
+		}
+		else if (command == "isready") std::cout << "readyok" << std::endl;
+		else if (command == "ucinewgame") positionFromFen(startFen, position);
+		else if (command == "position")
+		{
+			std::string token;
+			stream >> token;
+			std::string fen = startFen;
+			if (token == "fen")
+			{
+				fen = "";
+				while (stream >> token && token != "moves") fen += (fen == "" ? "" : " ") + token;
+			}
+			else stream >> token;
+			if (!positionFromFen(fen, position)) std::cout << "info string invalid fen " << fen << std::endl;
+			std::string move;
+			while (token == "moves" && stream >> move)
+			{
+				if (playUciMove(position, move)) continue;
+				std::cout << "info string illegal move " << move << std::endl;
+				break;
+			}
+		}
+		else if (command == "go") uciGo(position, stream);
+		else if (command == "quit") break;
+	}
+	analysisCache = nullptr;
+	return 0;
+}